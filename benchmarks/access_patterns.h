@@ -0,0 +1,191 @@
+#ifndef ACCESS_PATTERNS_H
+#define ACCESS_PATTERNS_H
+
+#include <cstdint>
+#include <cmath>
+#include <tuple>
+
+// Access pattern generators. Each one is a plain class whose next() returns
+// the next block index; composites take their parts as template parameters,
+// so a whole pattern inlines into the benchmark loop without virtual calls.
+
+#define ZIPF_DEFAULT_THETA 0.99
+
+// splitmix64: each pattern owns its stream, so results depend only on the seed
+class PatternRng {
+private:
+    uint64_t state;
+
+public:
+    explicit PatternRng(uint64_t seed) : state(seed) {}
+    
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+    uint64_t below(uint64_t bound) { return next() % bound; }
+    // Uniform in [0, 1) from the top 53 bits
+    double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+};
+
+// Independent stream `stream` of a run seed, for patterns that draw together
+inline uint64_t pattern_seed(uint64_t seed, uint64_t stream) {
+    return seed ^ (stream * 0xD1B54A32D192ED03ULL);
+}
+
+// base, base + 1, ..., base + footprint - 1, then around again
+class SequentialPattern {
+private:
+    uint64_t base;
+    uint64_t footprint;
+    uint64_t position;
+
+public:
+    SequentialPattern(uint64_t blocks, uint64_t first = 0)
+        : base(first), footprint(blocks), position(0) {}
+    
+    uint64_t next() {
+        uint64_t block = base + position;
+        position = (position + 1 == footprint) ? 0 : position + 1;
+        return block;
+    }
+};
+
+// Every stride-th block, wrapping inside the footprint
+class StridedPattern {
+private:
+    uint64_t stride;
+    uint64_t footprint;
+    uint64_t position;
+
+public:
+    StridedPattern(uint64_t step, uint64_t blocks)
+        : stride(step % blocks), footprint(blocks), position(0) {}
+    
+    uint64_t next() {
+        uint64_t block = position;
+        position += stride;
+        if (position >= footprint) {
+            position -= footprint;
+        }
+        return block;
+    }
+};
+
+class RandomPattern {
+private:
+    PatternRng rng;
+    uint64_t base;
+    uint64_t footprint;
+
+public:
+    RandomPattern(uint64_t blocks, uint64_t seed, uint64_t first = 0)
+        : rng(seed), base(first), footprint(blocks) {}
+    
+    uint64_t next() { return base + rng.below(footprint); }
+};
+
+// Block k is drawn with probability proportional to 1 / (k + 1)^theta, using
+// the closed-form approximation of Gray et al. (as in YCSB): after the zeta
+// sums are computed once, each draw is a few flops instead of a table search.
+// Needs 0 < theta < 1 and at least three blocks.
+class ZipfianPattern {
+private:
+    PatternRng rng;
+    uint64_t footprint;
+    double theta;
+    double alpha;
+    double zetan;
+    double zeta2;
+    double eta;
+
+public:
+    ZipfianPattern(uint64_t blocks, uint64_t seed, double skew = ZIPF_DEFAULT_THETA)
+        : rng(seed), footprint(blocks), theta(skew), alpha(1.0 / (1.0 - skew)), zetan(0.0) {
+        for (uint64_t i = 1; i <= footprint; i++) {
+            zetan += 1.0 / std::pow((double)i, theta);
+        }
+        zeta2 = 1.0 + 1.0 / std::pow(2.0, theta);
+        eta = (1.0 - std::pow(2.0 / footprint, 1.0 - theta)) / (1.0 - zeta2 / zetan);
+    }
+    
+    uint64_t next() {
+        double u = rng.uniform();
+        double uz = u * zetan;
+        if (uz < 1.0) {
+            return 0;
+        }
+        if (uz < zeta2) {
+            return 1;
+        }
+        uint64_t block = (uint64_t)(footprint * std::pow(eta * u - eta + 1.0, alpha));
+        return block < footprint ? block : footprint - 1;
+    }
+};
+
+// Draws from First with probability `weight`, otherwise from Second
+template <typename First, typename Second>
+class MixturePattern {
+private:
+    PatternRng rng;
+    double weight;
+    First first;
+    Second second;
+
+public:
+    MixturePattern(double first_weight, const First& a, const Second& b, uint64_t seed)
+        : rng(seed), weight(first_weight), first(a), second(b) {}
+    
+    uint64_t next() { return rng.uniform() < weight ? first.next() : second.next(); }
+};
+
+// A small hot region that gets `hot_weight` of the accesses, the rest spread
+// over a cold region placed right after it
+class HotColdPattern : public MixturePattern<RandomPattern, RandomPattern> {
+public:
+    HotColdPattern(uint64_t hot_blocks, uint64_t cold_blocks, double hot_weight, uint64_t seed)
+        : MixturePattern<RandomPattern, RandomPattern>(
+              hot_weight, RandomPattern(hot_blocks, pattern_seed(seed, 1)),
+              RandomPattern(cold_blocks, pattern_seed(seed, 2), hot_blocks), pattern_seed(seed, 3)) {}
+};
+
+// Runs each pattern for phase_length accesses in turn, cycling after the last.
+// The phase index selects the tuple element through a chain of compile-time
+// comparisons, which the branch predictor learns within each phase.
+template <typename... Phases>
+class PhasedPattern {
+private:
+    std::tuple<Phases...> phases;
+    uint64_t phase_length;
+    uint64_t position;
+    uint32_t current;
+    
+    template <size_t I>
+    uint64_t next_in(uint32_t phase) {
+        if constexpr (I + 1 < sizeof...(Phases)) {
+            if (phase != I) {
+                return next_in<I + 1>(phase);
+            }
+        }
+        return std::get<I>(phases).next();
+    }
+
+public:
+    PhasedPattern(uint64_t length, const Phases&... patterns)
+        : phases(patterns...), phase_length(length), position(0), current(0) {}
+    
+    uint64_t next() {
+        if (position == phase_length) {
+            position = 0;
+            current = (current + 1 == sizeof...(Phases)) ? 0 : current + 1;
+        }
+        position++;
+        return next_in<0>(current);
+    }
+    uint64_t get_phase_length() const { return phase_length; }
+    static constexpr uint32_t num_phases() { return sizeof...(Phases); }
+};
+
+#endif
@@ -0,0 +1,255 @@
+#include "../src/cache/victim_cache.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+// Each sample times a batch of operations with steady_clock and divides by
+// the batch size, so clock overhead is amortized. Samples outside Tukey's
+// fences (1.5 IQR beyond the quartiles) are dropped as interference.
+#define MICROBENCH_SAMPLES 31
+#define MICROBENCH_BATCH_OPS 20000
+#define MICROBENCH_RESIZE_SAMPLES 201
+#define MICROBENCH_OUTLIER_IQR 1.5
+
+struct MicrobenchResult {
+    std::string operation;
+    uint32_t size;
+    uint32_t samples;
+    uint32_t kept;
+    double mean_ns;
+    double stddev_ns;
+    double median_ns;
+    double min_ns;
+    double max_ns;
+};
+
+static volatile uint64_t sink;
+
+// Scattered block addresses, so neither the streaming filter nor the
+// sequential detector treats the fill as a stream
+static uint64_t block_address(uint64_t index) {
+    return ((index * 0x9E3779B97F4A7C15ULL) >> 20) * BLOCK_SIZE;
+}
+
+static double percentile(const std::vector<double>& sorted, double fraction) {
+    double position = fraction * (sorted.size() - 1);
+    size_t below = (size_t)position;
+    size_t above = std::min(below + 1, sorted.size() - 1);
+    return sorted[below] + (sorted[above] - sorted[below]) * (position - below);
+}
+
+static MicrobenchResult summarize(const std::string& operation, uint32_t size,
+                                  const std::vector<double>& samples) {
+    MicrobenchResult result;
+    result.operation = operation;
+    result.size = size;
+    result.samples = samples.size();
+    
+    std::vector<double> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    double q1 = percentile(sorted, 0.25);
+    double q3 = percentile(sorted, 0.75);
+    double low = q1 - MICROBENCH_OUTLIER_IQR * (q3 - q1);
+    double high = q3 + MICROBENCH_OUTLIER_IQR * (q3 - q1);
+    
+    std::vector<double> kept;
+    for (double sample : sorted) {
+        if (sample >= low && sample <= high) {
+            kept.push_back(sample);
+        }
+    }
+    
+    double sum = 0.0;
+    for (double sample : kept) {
+        sum += sample;
+    }
+    result.kept = kept.size();
+    result.mean_ns = sum / kept.size();
+    double squares = 0.0;
+    for (double sample : kept) {
+        squares += (sample - result.mean_ns) * (sample - result.mean_ns);
+    }
+    result.stddev_ns = kept.size() > 1 ? std::sqrt(squares / (kept.size() - 1)) : 0.0;
+    result.median_ns = percentile(kept, 0.5);
+    result.min_ns = kept.front();
+    result.max_ns = kept.back();
+    return result;
+}
+
+static double elapsed_ns(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+// A cache of `size` entries, every entry valid; returns the resident addresses
+static std::vector<uint64_t> warm_cache(VictimCache& cache, uint32_t size, uint64_t first_index) {
+    std::vector<uint64_t> resident;
+    for (uint64_t i = first_index; i < first_index + size; i++) {
+        uint64_t address = block_address(i);
+        cache.insert_smart(address, address / BLOCK_SIZE, nullptr, REUSE_PREDICTION_THRESHOLD);
+        resident.push_back(address);
+    }
+    return resident;
+}
+
+static MicrobenchResult bench_lookup(uint32_t size, bool hit) {
+    VictimCache cache(size);
+    cache.set_verbose(false);
+    std::vector<uint64_t> resident = warm_cache(cache, size, 0);
+    std::vector<uint64_t> probes = resident;
+    if (!hit) {
+        for (uint32_t i = 0; i < size; i++) {
+            probes[i] = block_address(size + i);
+        }
+    }
+    
+    std::vector<double> samples;
+    for (uint32_t s = 0; s < MICROBENCH_SAMPLES; s++) {
+        uint64_t found = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t op = 0; op < MICROBENCH_BATCH_OPS; op++) {
+            found += cache.lookup(probes[op % size]);
+        }
+        samples.push_back(elapsed_ns(start) / MICROBENCH_BATCH_OPS);
+        sink = found;
+    }
+    return summarize(hit ? "lookup_hit" : "lookup_miss", size, samples);
+}
+
+// Every insert misses and replaces the LRU entry of a full cache
+static MicrobenchResult bench_insert(uint32_t size) {
+    VictimCache cache(size);
+    cache.set_verbose(false);
+    warm_cache(cache, size, 0);
+    
+    std::vector<double> samples;
+    uint64_t next = size;
+    for (uint32_t s = 0; s < MICROBENCH_SAMPLES; s++) {
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t op = 0; op < MICROBENCH_BATCH_OPS; op++) {
+            uint64_t address = block_address(next++);
+            cache.insert_smart(address, address / BLOCK_SIZE, nullptr, REUSE_PREDICTION_THRESHOLD);
+        }
+        samples.push_back(elapsed_ns(start) / MICROBENCH_BATCH_OPS);
+    }
+    return summarize("insert_smart", size, samples);
+}
+
+// A batch empties the cache one LRU entry at a time; the refill is not timed
+static MicrobenchResult bench_evict(uint32_t size) {
+    VictimCache cache(size);
+    cache.set_verbose(false);
+    
+    std::vector<double> samples;
+    uint64_t next = 0;
+    for (uint32_t s = 0; s < MICROBENCH_SAMPLES; s++) {
+        warm_cache(cache, size, next);
+        next += size;
+        
+        uint64_t address = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t op = 0; op < size; op++) {
+            cache.evict_lru(address, nullptr);
+        }
+        samples.push_back(elapsed_ns(start) / size);
+        sink = address;
+    }
+    return summarize("evict_lru", size, samples);
+}
+
+// One sample is a shrink of the full cache to MIN_VICTIM_SIZE and the grow
+// back (or a grow to twice the minimum and back at the minimum size)
+static MicrobenchResult bench_resize(uint32_t size) {
+    VictimCache cache(size);
+    cache.set_verbose(false);
+    uint32_t other = size > MIN_VICTIM_SIZE ? MIN_VICTIM_SIZE : 2 * MIN_VICTIM_SIZE;
+    
+    std::vector<double> samples;
+    uint64_t next = 0;
+    for (uint32_t s = 0; s < MICROBENCH_RESIZE_SAMPLES; s++) {
+        warm_cache(cache, size, next);
+        next += size;
+        
+        auto start = std::chrono::steady_clock::now();
+        cache.resize(other);
+        cache.resize(size);
+        samples.push_back(elapsed_ns(start) / 2);
+    }
+    return summarize("resize", size, samples);
+}
+
+static void write_json(const std::vector<MicrobenchResult>& results, const std::string& path) {
+    std::ofstream out(path);
+    out << std::fixed << std::setprecision(2);
+    out << "{\n  \"unit\": \"ns/op\",\n  \"batch_ops\": " << MICROBENCH_BATCH_OPS
+        << ",\n  \"outlier_iqr\": " << MICROBENCH_OUTLIER_IQR << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const MicrobenchResult& r = results[i];
+        out << "    {\"operation\": \"" << r.operation << "\", \"size\": " << r.size
+            << ", \"samples\": " << r.samples << ", \"kept\": " << r.kept
+            << ", \"mean\": " << r.mean_ns << ", \"stddev\": " << r.stddev_ns
+            << ", \"median\": " << r.median_ns << ", \"min\": " << r.min_ns
+            << ", \"max\": " << r.max_ns << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<uint32_t> sizes = {64, 128, 256, 512, 1024};
+    std::string json_path = "results/microbench.json";
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--sizes" && i + 1 < argc) {
+            sizes.clear();
+            std::stringstream list(argv[++i]);
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                sizes.push_back(std::max<uint32_t>(MIN_VICTIM_SIZE, std::stoul(item)));
+            }
+        } else if (arg == "--json" && i + 1 < argc) {
+            json_path = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--sizes 64,128,...] [--json <file>]" << std::endl;
+            return 1;
+        }
+    }
+    
+    // Only the constructors log; keep them out of the table
+    std::streambuf* console = std::cout.rdbuf();
+    std::ostringstream discarded;
+    
+    std::vector<MicrobenchResult> results;
+    for (uint32_t size : sizes) {
+        std::cout.rdbuf(discarded.rdbuf());
+        results.push_back(bench_lookup(size, true));
+        results.push_back(bench_lookup(size, false));
+        results.push_back(bench_insert(size));
+        results.push_back(bench_evict(size));
+        results.push_back(bench_resize(size));
+        std::cout.rdbuf(console);
+        discarded.str("");
+    }
+    
+    std::cout << "\n=== VictimCache Microbenchmarks (ns/op) ===" << std::endl;
+    std::cout << std::setw(14) << std::left << "Operation" << std::right << std::setw(7) << "Size"
+              << std::setw(10) << "Mean" << std::setw(10) << "Stddev" << std::setw(10) << "Median"
+              << std::setw(10) << "Min" << std::setw(10) << "Kept" << std::endl;
+    std::cout << std::string(71, '-') << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const MicrobenchResult& r : results) {
+        std::cout << std::setw(14) << std::left << r.operation << std::right << std::setw(7) << r.size
+                  << std::setw(10) << r.mean_ns << std::setw(10) << r.stddev_ns
+                  << std::setw(10) << r.median_ns << std::setw(10) << r.min_ns
+                  << std::setw(6) << r.kept << "/" << r.samples << std::endl;
+    }
+    
+    write_json(results, json_path);
+    std::cout << "\nJSON written to " << json_path << std::endl;
+    return 0;
+}
@@ -1,268 +1,140 @@
 #include "synthetic_benchmark.h"
 #include <iostream>
 #include <iomanip>
-#include <cstdlib>
-#include <ctime>
+#include <algorithm>
 
-SyntheticBenchmark::SyntheticBenchmark(const std::string& name)
-    : benchmark_name(name), total_accesses(0), hits(0), misses(0) {
-    victim_cache = nullptr;
-    phase_detector = nullptr;
-    adaptive_controller = nullptr;
-}
-
-SyntheticBenchmark::~SyntheticBenchmark() {
-    teardown();
-}
-
-void SyntheticBenchmark::setup() {
-    victim_cache = new VictimCache(DEFAULT_VICTIM_SIZE);
-    phase_detector = new PhaseDetector();
-    adaptive_controller = new AdaptiveController(victim_cache, phase_detector);
-    
-    total_accesses = 0;
-    hits = 0;
-    misses = 0;
-    
-    std::cout << "\n[" << benchmark_name << "] Starting benchmark..." << std::endl;
-}
-
-void SyntheticBenchmark::teardown() {
-    if (victim_cache) {
-        delete victim_cache;
-        victim_cache = nullptr;
-    }
-    if (phase_detector) {
-        delete phase_detector;
-        phase_detector = nullptr;
-    }
-    if (adaptive_controller) {
-        delete adaptive_controller;
-        adaptive_controller = nullptr;
-    }
-}
+const char* const BENCHMARK_NAMES[] = {
+    "sequential", "random", "repeated", "strided", "mixed", "phase", "zipfian", "hotcold"
+};
+const size_t NUM_BENCHMARKS = sizeof(BENCHMARK_NAMES) / sizeof(BENCHMARK_NAMES[0]);
 
-void SyntheticBenchmark::print_results() const {
-    std::cout << "\n=== " << benchmark_name << " Results ===" << std::endl;
+void BenchmarkResult::print() const {
+    std::cout << "\n=== " << name << " Results ===" << std::endl;
     std::cout << "Total Accesses: " << total_accesses << std::endl;
     std::cout << "Hits: " << hits << std::endl;
     std::cout << "Misses: " << misses << std::endl;
-    std::cout << "Hit Rate: " << std::fixed << std::setprecision(2) 
+    std::cout << "Hit Rate: " << std::fixed << std::setprecision(2)
               << (get_hit_rate() * 100) << "%" << std::endl;
     std::cout << "=================================\n" << std::endl;
 }
 
-double SyntheticBenchmark::get_hit_rate() const {
-    if (total_accesses == 0) return 0.0;
-    return (double)hits / total_accesses;
-}
-
-void SequentialBenchmark::run() {
-    setup();
-    
-    for (uint64_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
-        uint64_t address = (i % ADDRESS_SPACE_SIZE) * BLOCK_SIZE;
-        
-        if (victim_cache->lookup(address)) {
-        } else {
-            victim_cache->insert(address, address >> 6, nullptr);
-        }
-        
-        phase_detector->record_instruction();
-        phase_detector->record_memory_access(false);
-    }
-    
-    // Get stats from victim cache
-    VictimStats& stats = victim_cache->get_stats();
-    total_accesses = stats.total_accesses;
-    hits = stats.victim_hits;
-    misses = stats.victim_misses;
-    
-    print_results();
-    victim_cache->print_stats();
-}
-
-void RandomBenchmark::run() {
-    setup();
-    srand(time(nullptr));
-    
-    for (uint64_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
-        uint64_t address = (rand() % ADDRESS_SPACE_SIZE) * BLOCK_SIZE;
-        
-        if (victim_cache->lookup(address)) {
-        } else {
-            victim_cache->insert(address, address >> 6, nullptr);
-        }
-        
-        phase_detector->record_instruction();
-        phase_detector->record_memory_access(false);
-    }
-    
-    // Get stats from victim cache
-    VictimStats& stats = victim_cache->get_stats();
-    total_accesses = stats.total_accesses;
-    hits = stats.victim_hits;
-    misses = stats.victim_misses;
-    
-    print_results();
-    victim_cache->print_stats();
-}
-
-void RepeatedBenchmark::run() {
-    setup();
-    
-    std::vector<uint64_t> working_set;
-    for (uint32_t i = 0; i < WORKING_SET_SIZE / 4; i++) {
-        working_set.push_back(i * BLOCK_SIZE);
-    }
-    
-    for (uint64_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
-        uint64_t address = working_set[i % working_set.size()];
-        
-        if (victim_cache->lookup(address)) {
-        } else {
-            victim_cache->insert(address, address >> 6, nullptr);
+bool is_benchmark(const std::string& name) {
+    for (size_t i = 0; i < NUM_BENCHMARKS; i++) {
+        if (name == BENCHMARK_NAMES[i]) {
+            return true;
         }
-        
-        phase_detector->record_instruction();
-        phase_detector->record_memory_access(false);
     }
-    
-    // Get stats from victim cache
-    VictimStats& stats = victim_cache->get_stats();
-    total_accesses = stats.total_accesses;
-    hits = stats.victim_hits;
-    misses = stats.victim_misses;
-    
-    print_results();
-    victim_cache->print_stats();
-}
-
-void StridedBenchmark::run() {
-    setup();
-    
-    for (uint64_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
-        uint64_t address = ((i * stride) % ADDRESS_SPACE_SIZE) * BLOCK_SIZE;
-        
-        if (victim_cache->lookup(address)) {
-        } else {
-            victim_cache->insert(address, address >> 6, nullptr);
-        }
-        
-        phase_detector->record_instruction();
-        phase_detector->record_memory_access(false);
+    return false;
+}
+
+// The first alarm after a boundary (and before the next one) detects it;
+// every other alarm is counted as false
+static void report_detection(const std::string& detector, const std::vector<uint64_t>& alarms,
+                             uint64_t phase_length, uint64_t iterations) {
+    uint64_t num_phases = iterations / phase_length;
+    uint64_t detected = 0;
+    uint64_t total_delay = 0;
+    uint64_t false_alarms = 0;
+    
+    std::cout << detector << ":" << std::endl;
+    if (num_phases < 2) {
+        std::cout << "  No phase boundary to detect" << std::endl;
+        return;
     }
-    
-    // Get stats from victim cache
-    VictimStats& stats = victim_cache->get_stats();
-    total_accesses = stats.total_accesses;
-    hits = stats.victim_hits;
-    misses = stats.victim_misses;
-    
-    print_results();
-    victim_cache->print_stats();
-}
-
-void MixedBenchmark::run() {
-    setup();
-    srand(time(nullptr));
-    
-    for (uint64_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
-        uint64_t address;
-        
-        if (rand() % 100 < 70) {
-            address = (i % ADDRESS_SPACE_SIZE) * BLOCK_SIZE;
-        } else {
-            address = (rand() % ADDRESS_SPACE_SIZE) * BLOCK_SIZE;
+    size_t next = 0;
+    for (uint64_t phase = 0; phase < num_phases; phase++) {
+        uint64_t start = phase * phase_length;
+        uint64_t end = start + phase_length;
+        bool found = false;
+        
+        for (; next < alarms.size() && alarms[next] < end; next++) {
+            if (phase == 0 || found) {
+                false_alarms++;
+                continue;
+            }
+            found = true;
+            detected++;
+            total_delay += alarms[next] - start;
+            std::cout << "  Boundary at " << start << ": detected after "
+                      << (alarms[next] - start) << " accesses" << std::endl;
         }
-        
-        if (victim_cache->lookup(address)) {
-        } else {
-            victim_cache->insert(address, address >> 6, nullptr);
+        if (phase > 0 && !found) {
+            std::cout << "  Boundary at " << start << ": missed" << std::endl;
         }
-        
-        phase_detector->record_instruction();
-        phase_detector->record_memory_access(false);
     }
-    
-    // Get stats from victim cache
-    VictimStats& stats = victim_cache->get_stats();
-    total_accesses = stats.total_accesses;
-    hits = stats.victim_hits;
-    misses = stats.victim_misses;
-    
-    print_results();
-    victim_cache->print_stats();
-}
-
-void PhaseBenchmark::run() {
-    setup();
-    srand(time(nullptr));
-    
-    uint64_t phase_length = BENCHMARK_ITERATIONS / 4;
-    
-    for (uint64_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
-        uint64_t address;
-        uint64_t phase = i / phase_length;
-        
-        switch (phase) {
-            case 0:
-                address = (i % ADDRESS_SPACE_SIZE) * BLOCK_SIZE;
-                break;
-            case 1:
-                address = (rand() % ADDRESS_SPACE_SIZE) * BLOCK_SIZE;
-                break;
-            case 2:
-                address = ((i % 64) * BLOCK_SIZE);
-                break;
-            case 3:
-                address = ((i * 8) % ADDRESS_SPACE_SIZE) * BLOCK_SIZE;
-                break;
-            default:
-                address = (rand() % ADDRESS_SPACE_SIZE) * BLOCK_SIZE;
-                break;
-        }
-        
-        bool is_hit = victim_cache->lookup(address);
-        if (!is_hit) {
-            victim_cache->insert(address, address >> 6, nullptr);
-        }
-        
-        phase_detector->record_instruction();
-        phase_detector->record_memory_access(!is_hit);
-        
-        if (phase_detector->check_phase_change()) {
-            std::cout << "[Phase Change Detected at " << i << " instructions]" << std::endl;
-            phase_detector->print_phase_info();
+    false_alarms += alarms.size() - next;
+    
+    std::cout << "  Detected: " << detected << "/" << (num_phases - 1)
+              << ", mean delay: " << (detected > 0 ? total_delay / detected : 0)
+              << " accesses, false alarms: " << false_alarms << std::endl;
+}
+
+static BenchmarkCacheMode resolve_mode(const BenchmarkRun& run, BenchmarkCacheMode preferred) {
+    return run.mode == BENCH_CACHE_DEFAULT ? preferred : run.mode;
+}
+
+BenchmarkResult run_benchmark(const std::string& name, const BenchmarkRun& run) {
+    uint64_t seed = run.seed;
+    
+    if (name == "sequential") {
+        SequentialPattern pattern(ADDRESS_SPACE_SIZE);
+        return run_pattern("Sequential Access", pattern, run, resolve_mode(run, BENCH_CACHE_STATIC));
+    } else if (name == "random") {
+        RandomPattern pattern(ADDRESS_SPACE_SIZE, seed);
+        return run_pattern("Random Access", pattern, run, resolve_mode(run, BENCH_CACHE_STATIC));
+    } else if (name == "repeated") {
+        SequentialPattern pattern(WORKING_SET_SIZE / 4);
+        return run_pattern("Repeated Access", pattern, run, resolve_mode(run, BENCH_CACHE_STATIC));
+    } else if (name == "strided") {
+        StridedPattern pattern(16, ADDRESS_SPACE_SIZE);
+        return run_pattern("Strided Access", pattern, run, resolve_mode(run, BENCH_CACHE_STATIC));
+    } else if (name == "mixed") {
+        MixturePattern<SequentialPattern, RandomPattern> pattern(
+            0.7, SequentialPattern(ADDRESS_SPACE_SIZE),
+            RandomPattern(ADDRESS_SPACE_SIZE, pattern_seed(seed, 1)), pattern_seed(seed, 2));
+        return run_pattern("Mixed Access", pattern, run, resolve_mode(run, BENCH_CACHE_STATIC));
+    } else if (name == "zipfian") {
+        ZipfianPattern pattern(ADDRESS_SPACE_SIZE, seed);
+        return run_pattern("Zipfian Access", pattern, run, resolve_mode(run, BENCH_CACHE_STATIC));
+    } else if (name == "hotcold") {
+        HotColdPattern pattern(WORKING_SET_SIZE / 4, ADDRESS_SPACE_SIZE * 4, 0.9, seed);
+        return run_pattern("Hot/Cold Access", pattern, run, resolve_mode(run, BENCH_CACHE_STATIC));
+    } else if (name == "phase") {
+        // Four phases with known boundaries, so the run also scores both
+        // phase detectors on detection delay and false alarms
+        typedef PhasedPattern<SequentialPattern, RandomPattern, SequentialPattern, StridedPattern> FourPhases;
+        uint64_t phase_length = std::max<uint64_t>(1, run.iterations / FourPhases::num_phases());
+        FourPhases pattern(phase_length, SequentialPattern(ADDRESS_SPACE_SIZE), RandomPattern(ADDRESS_SPACE_SIZE, seed),
+                           SequentialPattern(64), StridedPattern(8, ADDRESS_SPACE_SIZE));
+        // Whole phases only; a partial fifth phase would score its alarms as false
+        BenchmarkRun phase_run = run;
+        phase_run.iterations = phase_length * FourPhases::num_phases();
+        if (phase_run.iterations != run.iterations) {
+            std::cout << "[Benchmark] Running " << phase_run.iterations << " accesses, "
+                      << FourPhases::num_phases() << " whole phases" << std::endl;
         }
-        
-        adaptive_controller->update(1);
+        BenchmarkResult result = run_pattern("Phase-Changing Workload", pattern, phase_run,
+                                             resolve_mode(run, BENCH_CACHE_ADAPTIVE));
+        
+        std::cout << "\n=== Phase Detection Evaluation ===" << std::endl;
+        std::cout << "Page-Hinkley sensitivity: delta=" << run.change_delta
+                  << " lambda=" << run.change_lambda << std::endl;
+        report_detection("Window (signature)", result.window_alarms, phase_length, phase_run.iterations);
+        report_detection("Change-point (PH)", result.stream_alarms, phase_length, phase_run.iterations);
+        std::cout << "==================================\n" << std::endl;
+        return result;
     }
     
-    // Get stats from victim cache
-    VictimStats& stats = victim_cache->get_stats();
-    total_accesses = stats.total_accesses;
-    hits = stats.victim_hits;
-    misses = stats.victim_misses;
-    
-    print_results();
-    victim_cache->print_stats();
-    phase_detector->print_phase_info();
-    adaptive_controller->print_adaptation_history();
+    std::cerr << "Unknown benchmark: " << name << std::endl;
+    return BenchmarkResult();
 }
 
-BenchmarkSuite::BenchmarkSuite() {
+BenchmarkSuite::BenchmarkSuite(const BenchmarkRun& options) : run(options) {
     std::cout << "=== Benchmark Suite Initialized ===" << std::endl;
 }
 
-BenchmarkSuite::~BenchmarkSuite() {
-    for (auto* bench : benchmarks) {
-        delete bench;
-    }
-}
-
-void BenchmarkSuite::add_benchmark(SyntheticBenchmark* bench) {
-    benchmarks.push_back(bench);
+void BenchmarkSuite::add_benchmark(const std::string& name) {
+    benchmarks.push_back(name);
 }
 
 void BenchmarkSuite::run_all() {
@@ -270,8 +142,9 @@ void BenchmarkSuite::run_all() {
     std::cout << "Starting Benchmark Suite" << std::endl;
     std::cout << "========================================\n" << std::endl;
     
-    for (auto* bench : benchmarks) {
-        bench->run();
+    results.clear();
+    for (const std::string& name : benchmarks) {
+        results.push_back(run_benchmark(name, run));
     }
     
     print_summary();
@@ -281,7 +154,10 @@ void BenchmarkSuite::print_summary() const {
     std::cout << "\n========================================" << std::endl;
     std::cout << "Benchmark Suite Summary" << std::endl;
     std::cout << "========================================" << std::endl;
-    std::cout << "Total Benchmarks Run: " << benchmarks.size() << std::endl;
+    std::cout << "Total Benchmarks Run: " << results.size() << std::endl;
+    for (const BenchmarkResult& result : results) {
+        std::cout << "  " << std::left << std::setw(26) << result.name << std::right
+                  << std::fixed << std::setprecision(2) << (result.get_hit_rate() * 100) << "%" << std::endl;
+    }
     std::cout << "========================================\n" << std::endl;
 }
-
@@ -0,0 +1,385 @@
+#ifndef TRACE_KERNELS_H
+#define TRACE_KERNELS_H
+
+#include "access_patterns.h"
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+// Instrumented kernels: each one really computes its result on real data and
+// reports every load and store of its data structures to a sink as
+// sink.access(address, is_write). Addresses are logical: every structure gets
+// its own region from a KernelAddressSpace, laid out the way a heap would
+// place it. Building the input is not traced, only the kernel itself.
+//
+// The sink is a template parameter, so the same kernel can fill a TraceSink
+// or drive a simulator directly without a call through a pointer per access.
+
+#define KERNEL_REGION_ALIGN 4096
+
+#define KERNEL_MATMUL_N 64
+#define KERNEL_MATMUL_TILE 16
+#define KERNEL_CHASE_NODES 1024
+#define KERNEL_CHASE_NODE_BYTES 64
+#define KERNEL_CHASE_STEPS 500000
+#define KERNEL_JOIN_BUILD_ROWS 2048
+#define KERNEL_JOIN_PROBE_ROWS 131072
+#define KERNEL_JOIN_MATCH_FRACTION 0.5
+#define KERNEL_BFS_VERTICES 8192
+#define KERNEL_BFS_DEGREE 8
+#define KERNEL_LSM_RUNS 12
+#define KERNEL_LSM_RUN_LENGTH 16384
+
+// Collects a kernel's accesses as a trace
+struct TraceSink {
+    std::vector<uint64_t> addresses;
+    std::vector<bool> writes;
+    
+    void access(uint64_t address, bool is_write) {
+        addresses.push_back(address);
+        writes.push_back(is_write);
+    }
+};
+
+// Bump allocator over the logical address space; regions never overlap
+class KernelAddressSpace {
+private:
+    uint64_t next_base;
+
+public:
+    KernelAddressSpace() : next_base(KERNEL_REGION_ALIGN) {}
+    
+    // `align` must be a power of two
+    uint64_t allocate(uint64_t bytes, uint64_t align = KERNEL_REGION_ALIGN) {
+        uint64_t base = (next_base + align - 1) & ~(align - 1);
+        next_base = base + bytes;
+        return base;
+    }
+};
+
+inline uint64_t next_power_of_two(uint64_t value) {
+    uint64_t power = 1;
+    while (power < value) {
+        power <<= 1;
+    }
+    return power;
+}
+
+// C = A * B on n x n row-major doubles in i-j-k order. Every k step walks a
+// column of B, touching a new block per access once a row exceeds a block.
+template <typename Sink>
+double kernel_matmul(Sink& sink, uint32_t n) {
+    KernelAddressSpace space;
+    uint64_t a_base = space.allocate((uint64_t)n * n * sizeof(double));
+    uint64_t b_base = space.allocate((uint64_t)n * n * sizeof(double));
+    uint64_t c_base = space.allocate((uint64_t)n * n * sizeof(double));
+    std::vector<double> a(n * n), b(n * n), c(n * n);
+    for (uint32_t i = 0; i < n * n; i++) {
+        a[i] = (i % 7) * 0.5;
+        b[i] = (i % 5) * 0.25;
+    }
+    
+    for (uint32_t i = 0; i < n; i++) {
+        for (uint32_t j = 0; j < n; j++) {
+            double sum = 0.0;
+            for (uint32_t k = 0; k < n; k++) {
+                sink.access(a_base + (i * n + k) * sizeof(double), false);
+                sink.access(b_base + (k * n + j) * sizeof(double), false);
+                sum += a[i * n + k] * b[k * n + j];
+            }
+            c[i * n + j] = sum;
+            sink.access(c_base + (i * n + j) * sizeof(double), true);
+        }
+    }
+    return c[n * n - 1];
+}
+
+// The same product blocked into tile x tile sub-matrices, so the three tiles
+// in use stay resident while they are reused
+template <typename Sink>
+double kernel_matmul_tiled(Sink& sink, uint32_t n, uint32_t tile) {
+    KernelAddressSpace space;
+    uint64_t a_base = space.allocate((uint64_t)n * n * sizeof(double));
+    uint64_t b_base = space.allocate((uint64_t)n * n * sizeof(double));
+    uint64_t c_base = space.allocate((uint64_t)n * n * sizeof(double));
+    std::vector<double> a(n * n), b(n * n), c(n * n, 0.0);
+    for (uint32_t i = 0; i < n * n; i++) {
+        a[i] = (i % 7) * 0.5;
+        b[i] = (i % 5) * 0.25;
+    }
+    
+    for (uint32_t ii = 0; ii < n; ii += tile) {
+        for (uint32_t jj = 0; jj < n; jj += tile) {
+            for (uint32_t kk = 0; kk < n; kk += tile) {
+                for (uint32_t i = ii; i < std::min(ii + tile, n); i++) {
+                    for (uint32_t j = jj; j < std::min(jj + tile, n); j++) {
+                        sink.access(c_base + (i * n + j) * sizeof(double), false);
+                        double sum = c[i * n + j];
+                        for (uint32_t k = kk; k < std::min(kk + tile, n); k++) {
+                            sink.access(a_base + (i * n + k) * sizeof(double), false);
+                            sink.access(b_base + (k * n + j) * sizeof(double), false);
+                            sum += a[i * n + k] * b[k * n + j];
+                        }
+                        c[i * n + j] = sum;
+                        sink.access(c_base + (i * n + j) * sizeof(double), true);
+                    }
+                }
+            }
+        }
+    }
+    return c[n * n - 1];
+}
+
+// Follows a linked list whose nodes form one random cycle (Sattolo's
+// shuffle), so each step depends on the last and lands on an unrelated block
+template <typename Sink>
+uint64_t kernel_pointer_chase(Sink& sink, uint32_t nodes, uint64_t steps, uint64_t seed) {
+    KernelAddressSpace space;
+    uint64_t node_base = space.allocate((uint64_t)nodes * KERNEL_CHASE_NODE_BYTES);
+    std::vector<uint32_t> next(nodes);
+    for (uint32_t i = 0; i < nodes; i++) {
+        next[i] = i;
+    }
+    PatternRng rng(seed);
+    for (uint32_t i = nodes - 1; i > 0; i--) {
+        std::swap(next[i], next[rng.below(i)]);
+    }
+    
+    uint32_t current = 0;
+    uint64_t visited = 0;
+    for (uint64_t s = 0; s < steps; s++) {
+        sink.access(node_base + (uint64_t)current * KERNEL_CHASE_NODE_BYTES, false);
+        current = next[current];
+        visited += current;
+    }
+    return visited;
+}
+
+// Hash join of a probe relation against a build relation on 64-bit keys.
+// The build side goes into an open-addressing table (linear probing, twice
+// the rows in slots); both relations are scanned in order, and matches are
+// appended to an output buffer.
+template <typename Sink>
+uint64_t kernel_hash_join(Sink& sink, uint32_t build_rows, uint32_t probe_rows, uint64_t seed) {
+    struct Row { uint64_t key; uint64_t payload; };
+    const uint64_t EMPTY = 0;
+    uint64_t slots = next_power_of_two((uint64_t)build_rows * 2);
+    
+    KernelAddressSpace space;
+    uint64_t build_base = space.allocate((uint64_t)build_rows * sizeof(Row));
+    uint64_t probe_base = space.allocate((uint64_t)probe_rows * sizeof(Row));
+    uint64_t table_base = space.allocate(slots * sizeof(Row));
+    uint64_t output_base = space.allocate((uint64_t)probe_rows * sizeof(Row));
+    
+    PatternRng rng(seed);
+    std::vector<Row> build(build_rows), probe(probe_rows), table(slots, Row{EMPTY, 0});
+    for (uint32_t i = 0; i < build_rows; i++) {
+        build[i] = Row{(rng.next() | 1), i};
+    }
+    for (uint32_t i = 0; i < probe_rows; i++) {
+        bool match = rng.uniform() < KERNEL_JOIN_MATCH_FRACTION;
+        probe[i] = Row{match ? build[rng.below(build_rows)].key : (rng.next() | 1), i};
+    }
+    auto slot_of = [slots](uint64_t key) { return ((key * 0x9E3779B97F4A7C15ULL) >> 20) & (slots - 1); };
+    
+    for (uint32_t i = 0; i < build_rows; i++) {
+        sink.access(build_base + (uint64_t)i * sizeof(Row), false);
+        uint64_t slot = slot_of(build[i].key);
+        sink.access(table_base + slot * sizeof(Row), false);
+        while (table[slot].key != EMPTY) {
+            slot = (slot + 1) & (slots - 1);
+            sink.access(table_base + slot * sizeof(Row), false);
+        }
+        table[slot] = build[i];
+        sink.access(table_base + slot * sizeof(Row), true);
+    }
+    
+    uint64_t matches = 0;
+    for (uint32_t i = 0; i < probe_rows; i++) {
+        sink.access(probe_base + (uint64_t)i * sizeof(Row), false);
+        uint64_t slot = slot_of(probe[i].key);
+        sink.access(table_base + slot * sizeof(Row), false);
+        while (table[slot].key != EMPTY && table[slot].key != probe[i].key) {
+            slot = (slot + 1) & (slots - 1);
+            sink.access(table_base + slot * sizeof(Row), false);
+        }
+        if (table[slot].key == probe[i].key) {
+            sink.access(output_base + matches * sizeof(Row), true);
+            matches++;
+        }
+    }
+    return matches;
+}
+
+// Breadth-first search from vertex 0 over a random graph in CSR form
+// (offsets, edges) with `degree` out-edges per vertex. Each frontier vertex
+// reads its offsets and edge list in order, then the distances of scattered
+// neighbours.
+template <typename Sink>
+uint64_t kernel_bfs(Sink& sink, uint32_t vertices, uint32_t degree, uint64_t seed) {
+    uint64_t num_edges = (uint64_t)vertices * degree;
+    KernelAddressSpace space;
+    uint64_t offsets_base = space.allocate(((uint64_t)vertices + 1) * sizeof(uint64_t));
+    uint64_t edges_base = space.allocate(num_edges * sizeof(uint32_t));
+    uint64_t dist_base = space.allocate((uint64_t)vertices * sizeof(uint32_t));
+    uint64_t queue_base = space.allocate((uint64_t)vertices * sizeof(uint32_t));
+    
+    PatternRng rng(seed);
+    std::vector<uint64_t> offsets(vertices + 1);
+    std::vector<uint32_t> edges(num_edges);
+    for (uint32_t v = 0; v <= vertices; v++) {
+        offsets[v] = (uint64_t)v * degree;
+    }
+    for (uint64_t e = 0; e < num_edges; e++) {
+        edges[e] = rng.below(vertices);
+    }
+    const uint32_t UNVISITED = UINT32_MAX;
+    std::vector<uint32_t> dist(vertices, UNVISITED), queue(vertices);
+    
+    uint32_t head = 0;
+    uint32_t tail = 0;
+    dist[0] = 0;
+    sink.access(dist_base, true);
+    queue[tail++] = 0;
+    sink.access(queue_base, true);
+    while (head < tail) {
+        sink.access(queue_base + (uint64_t)head * sizeof(uint32_t), false);
+        uint32_t v = queue[head++];
+        sink.access(offsets_base + (uint64_t)v * sizeof(uint64_t), false);
+        sink.access(offsets_base + ((uint64_t)v + 1) * sizeof(uint64_t), false);
+        for (uint64_t e = offsets[v]; e < offsets[v + 1]; e++) {
+            sink.access(edges_base + e * sizeof(uint32_t), false);
+            uint32_t u = edges[e];
+            sink.access(dist_base + (uint64_t)u * sizeof(uint32_t), false);
+            if (dist[u] == UNVISITED) {
+                dist[u] = dist[v] + 1;
+                sink.access(dist_base + (uint64_t)u * sizeof(uint32_t), true);
+                queue[tail] = u;
+                sink.access(queue_base + (uint64_t)tail * sizeof(uint32_t), true);
+                tail++;
+            }
+        }
+    }
+    return tail;
+}
+
+// k-way merge of sorted runs through a binary min-heap, as in an LSM-tree
+// compaction. Each run starts on a boundary of its own power-of-two size, as
+// a size-class allocator would place it, so the k read cursors start out in
+// the same cache sets.
+template <typename Sink>
+uint64_t kernel_lsm_merge(Sink& sink, uint32_t runs, uint32_t run_length, uint64_t seed) {
+    struct HeapEntry { uint64_t key; uint32_t run; uint32_t position; };
+    uint64_t run_bytes = (uint64_t)run_length * sizeof(uint64_t);
+    
+    KernelAddressSpace space;
+    std::vector<uint64_t> run_bases(runs);
+    for (uint32_t r = 0; r < runs; r++) {
+        run_bases[r] = space.allocate(run_bytes, next_power_of_two(run_bytes));
+    }
+    uint64_t heap_base = space.allocate((uint64_t)runs * sizeof(HeapEntry));
+    uint64_t output_base = space.allocate(run_bytes * runs);
+    
+    PatternRng rng(seed);
+    std::vector<std::vector<uint64_t>> data(runs, std::vector<uint64_t>(run_length));
+    for (uint32_t r = 0; r < runs; r++) {
+        for (uint32_t i = 0; i < run_length; i++) {
+            data[r][i] = rng.next() >> 1;
+        }
+        std::sort(data[r].begin(), data[r].end());
+    }
+    
+    std::vector<HeapEntry> heap;
+    auto touch_heap = [&](size_t index, bool is_write) {
+        sink.access(heap_base + index * sizeof(HeapEntry), is_write);
+    };
+    auto sift_down = [&](size_t index) {
+        while (true) {
+            size_t smallest = index;
+            for (size_t child = 2 * index + 1; child <= 2 * index + 2 && child < heap.size(); child++) {
+                touch_heap(child, false);
+                if (heap[child].key < heap[smallest].key) {
+                    smallest = child;
+                }
+            }
+            if (smallest == index) {
+                return;
+            }
+            std::swap(heap[index], heap[smallest]);
+            touch_heap(index, true);
+            touch_heap(smallest, true);
+            index = smallest;
+        }
+    };
+    
+    for (uint32_t r = 0; r < runs; r++) {
+        sink.access(run_bases[r], false);
+        heap.push_back(HeapEntry{data[r][0], r, 0});
+        touch_heap(r, true);
+    }
+    for (size_t i = heap.size() / 2; i-- > 0;) {
+        sift_down(i);
+    }
+    
+    uint64_t written = 0;
+    uint64_t checksum = 0;
+    while (!heap.empty()) {
+        touch_heap(0, false);
+        HeapEntry top = heap[0];
+        sink.access(output_base + written * sizeof(uint64_t), true);
+        checksum += top.key * (written + 1);
+        written++;
+        
+        if (top.position + 1 < run_length) {
+            top.position++;
+            sink.access(run_bases[top.run] + (uint64_t)top.position * sizeof(uint64_t), false);
+            top.key = data[top.run][top.position];
+            heap[0] = top;
+        } else {
+            touch_heap(heap.size() - 1, false);
+            heap[0] = heap.back();
+            heap.pop_back();
+        }
+        if (!heap.empty()) {
+            touch_heap(0, true);
+            sift_down(0);
+        }
+    }
+    return checksum;
+}
+
+// Names accepted by run_kernel()
+static const char* const KERNEL_NAMES[] = {
+    "matmul", "matmul_tiled", "pointer_chase", "hash_join", "bfs", "lsm_merge"
+};
+static const size_t NUM_KERNELS = sizeof(KERNEL_NAMES) / sizeof(KERNEL_NAMES[0]);
+
+// Runs the named kernel with its default input scaled by `scale`: element
+// counts grow linearly, the matrix side by the cube root so the work does
+// too. Returns false for an unknown name.
+template <typename Sink>
+bool run_kernel(const std::string& name, Sink& sink, double scale = 1.0, uint64_t seed = 1) {
+    auto scaled = [scale](uint64_t value) { return std::max<uint64_t>(1, (uint64_t)(value * scale)); };
+    uint32_t side = std::max<uint32_t>(KERNEL_MATMUL_TILE, (uint32_t)(KERNEL_MATMUL_N * std::cbrt(scale)));
+    
+    if (name == "matmul") {
+        kernel_matmul(sink, side);
+    } else if (name == "matmul_tiled") {
+        kernel_matmul_tiled(sink, side, KERNEL_MATMUL_TILE);
+    } else if (name == "pointer_chase") {
+        kernel_pointer_chase(sink, scaled(KERNEL_CHASE_NODES), scaled(KERNEL_CHASE_STEPS), seed);
+    } else if (name == "hash_join") {
+        kernel_hash_join(sink, scaled(KERNEL_JOIN_BUILD_ROWS), scaled(KERNEL_JOIN_PROBE_ROWS), seed);
+    } else if (name == "bfs") {
+        kernel_bfs(sink, scaled(KERNEL_BFS_VERTICES), KERNEL_BFS_DEGREE, seed);
+    } else if (name == "lsm_merge") {
+        kernel_lsm_merge(sink, KERNEL_LSM_RUNS, scaled(KERNEL_LSM_RUN_LENGTH), seed);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+#endif
@@ -1,7 +1,6 @@
 #ifndef VICTIM_CACHE_CONFIG_H
 #define VICTIM_CACHE_CONFIG_H
 
-#define STATIC_VICTIM_SIZE 128
 #define VICTIM_ASSOCIATIVITY 128
 #define CACHE_BLOCK_SIZE 64
 
@@ -10,24 +9,8 @@
 
 #define STATS_WINDOW 10000
 
-#define ADAPTIVE_MIN_SIZE 64
-#define ADAPTIVE_MAX_SIZE 256
-#define ADAPTIVE_DEFAULT_SIZE 80
-#define SIZE_STEP 32
-
-#define HIT_RATE_HIGH_THRESH 0.08
-#define HIT_RATE_LOW_THRESH 0.02
-#define OCCUPANCY_HIGH_THRESH 0.80
-#define OCCUPANCY_LOW_THRESH 0.30
-
-#define PHASE_DETECTION_WINDOW 50000
-#define PHASE_HISTORY_LENGTH 10
-#define PHASE_CHANGE_THRESH 0.15
-
-#define MEM_INTENSIVE_THRESH 100.0
-#define HIGH_MISS_RATE_THRESH 0.10
-
-#define ADAPT_CHECK_INTERVAL 50000
+// Victim cache sizes, adaptation and phase-detection thresholds are run-time
+// settings now: see src/config/sim_config.h and config/default.cfg
 
 #define BENCHMARK_ITERATIONS 1000000
 #define ADDRESS_SPACE 1024
@@ -1,39 +1,143 @@
 #include "adaptive_controller.h"
+#include "../monitoring/profiler.h"
 #include <iostream>
 #include <iomanip>
 #include <fstream>
 #include <algorithm>
+#include <cmath>
 
-AdaptiveController::AdaptiveController(VictimCache* vc, PhaseDetector* pd)
-    : victim_cache(vc), phase_detector(pd), last_adaptation_time(0), 
-      instruction_count(0) {
+AdaptiveController::AdaptiveController(VictimCache* vc, PhaseDetector* pd, const SimConfig& config)
+    : victim_cache(vc), phase_detector(pd), adaptation_interval(config.adaptation_interval),
+      size_step(config.size_step), hit_rate_high(config.hit_rate_high),
+      hit_rate_low(config.hit_rate_low), occupancy_high(config.occupancy_high),
+      occupancy_low(config.occupancy_low), reuse_threshold(config.reuse_threshold),
+      streaming_threshold(config.streaming_threshold), last_adaptation_time(0), 
+      instruction_count(0), phase_change_pending(false), phase_triggered_adaptations(0),
+      active_phase_id(-1),
+      memo_restores(0), intervals_saved(0), proactive(false), preadapted_phase_id(-1),
+      proactive_adaptations(0), proactive_confirmed(0), policy(POLICY_HYBRID),
+      entry_cost(MRC_ENTRY_COST), mrc_start_hits(MRC_NUM_BUCKETS, 0),
+      target_size(0), objective(OBJECTIVE_HIT_RATE), miss_penalty_cycles(EDP_MISS_PENALTY_CYCLES),
+      interval_start_fills(0), control_target(TARGET_HIT_RATE), setpoint(PID_HIT_RATE_SETPOINT),
+      pid_integral(0.0), pid_prev_error(0.0), last_resize_time(0), last_resize_direction(0),
+      oscillations(0), current_arm(-1),
+      move_direction(0), move_start(0), move_last_resize(0), move_total(0), size_moves(0) {
+    update_stack_distance_tracking();
     std::cout << "[AdaptiveController] Initialized" << std::endl;
 }
 
+void AdaptiveController::update_stack_distance_tracking() {
+    if (victim_cache) {
+        victim_cache->set_stack_distance_tracking(policy == POLICY_MRC || objective == OBJECTIVE_EDP);
+    }
+}
+
 void AdaptiveController::update(uint64_t instructions) {
+    VC_PROFILE_SCOPE(PROF_CONTROLLER_UPDATE);
     instruction_count += instructions;
     
+    if (proactive) {
+        preadapt_for_predicted_phase();
+    }
+    
     if (should_adapt()) {
         check_and_adapt();
     }
 }
 
 bool AdaptiveController::should_adapt() const {
-    return (instruction_count - last_adaptation_time) >= ADAPTATION_INTERVAL;
+    uint64_t interval = (policy == POLICY_BANDIT) ? BANDIT_INTERVAL : adaptation_interval;
+    return phase_change_pending ||
+           (instruction_count - last_adaptation_time) >= interval;
 }
 
 AdaptiveDecision AdaptiveController::make_decision() {
+    if (policy == POLICY_MRC) {
+        target_size = calculate_optimal_size();
+        return DECISION_SET_SIZE;
+    }
+    if (policy == POLICY_PID) {
+        return pid_policy();
+    }
+    if (policy == POLICY_BANDIT) {
+        return bandit_policy();
+    }
     return hybrid_policy();
 }
 
+uint32_t AdaptiveController::calculate_optimal_size() {
+    uint32_t current_size = victim_cache->get_current_size();
+    const std::vector<uint64_t>& hits = victim_cache->get_stack_distance_hits();
+    uint64_t lookups = victim_cache->get_metrics().lookups.get();
+    if (lookups < MRC_MIN_LOOKUPS) {
+        return current_size;
+    }
+    
+    // Interval hits each candidate size would have had. A count below the
+    // snapshot was zeroed by VictimCache::reset_stats() and counts from there.
+    std::vector<uint64_t> size_hits(MRC_NUM_BUCKETS, 0);
+    uint64_t cumulative_hits = 0;
+    for (uint32_t b = 0; b < MRC_NUM_BUCKETS; b++) {
+        cumulative_hits += hits[b] >= mrc_start_hits[b] ? hits[b] - mrc_start_hits[b] : hits[b];
+        size_hits[b] = cumulative_hits;
+    }
+    // A cache built above MAX_VICTIM_SIZE is compared as the largest bucket
+    uint32_t current_bucket = std::min<uint32_t>(std::max(current_size / MRC_BUCKET_SIZE, 1u) - 1, MRC_NUM_BUCKETS - 1);
+    
+    // Strict > keeps the smallest of equally good sizes
+    uint32_t best_size = MIN_VICTIM_SIZE;
+    double best_score = 0.0;
+    bool found = false;
+    for (uint32_t b = 0; b < MRC_NUM_BUCKETS; b++) {
+        uint32_t size = (b + 1) * MRC_BUCKET_SIZE;
+        if (size < MIN_VICTIM_SIZE) {
+            continue;
+        }
+        double score;
+        if (objective == OBJECTIVE_EDP) {
+            score = -estimate_interval_edp(size, size_hits[b], size_hits[current_bucket], lookups);
+        } else {
+            score = (double)size_hits[b] / lookups - entry_cost * size;
+        }
+        if (!found || score > best_score) {
+            best_score = score;
+            best_size = size;
+            found = true;
+        }
+    }
+    return best_size;
+}
+
+double AdaptiveController::estimate_interval_edp(uint32_t size, uint64_t hits, uint64_t current_hits,
+                                                 uint64_t lookups) const {
+    const EnergyStats& energy = victim_cache->get_energy_stats();
+    uint64_t cycles = energy.cycles - interval_start_energy.cycles;
+    uint64_t fills = total_fills() - interval_start_fills;
+    uint32_t current_size = victim_cache->get_current_size();
+    
+    double delay = (double)cycles + ((double)current_hits - (double)hits) * miss_penalty_cycles;
+    delay = std::max(delay, 1.0);
+    
+    bool gating = victim_cache->is_power_gating();
+    uint32_t powered = gating ? size : MAX_VICTIM_SIZE;
+    uint32_t woken = (gating && size > current_size) ? size - current_size : 0;
+    double energy_pj = victim_cache->get_energy_model().estimate_energy(
+        size, powered, lookups, hits, fills, (uint64_t)delay, woken);
+    return energy_pj * delay;
+}
+
+uint64_t AdaptiveController::total_fills() const {
+    const VictimStats& stats = victim_cache->get_stats();
+    return stats.victim_insertions + stats.prefetch_insertions + stats.swaps;
+}
+
 AdaptiveDecision AdaptiveController::hit_rate_based_policy() {
-    VictimStats& stats = victim_cache->get_stats();
-    double hit_rate = stats.hit_rate;
+    double hit_rate = victim_cache->get_metrics().hit_window.rate();
     double occupancy = victim_cache->get_occupancy();
     
-    if (hit_rate > HIT_RATE_THRESHOLD_HIGH && occupancy > OCCUPANCY_THRESHOLD_HIGH) {
+    if (hit_rate > hit_rate_high && occupancy > occupancy_high) {
         return DECISION_INCREASE_SIZE;
-    } else if (hit_rate < HIT_RATE_THRESHOLD_LOW && occupancy < OCCUPANCY_THRESHOLD_LOW) {
+    } else if (hit_rate < hit_rate_low && occupancy < occupancy_low) {
         return DECISION_DECREASE_SIZE;
     }
     
@@ -42,13 +146,13 @@ AdaptiveDecision AdaptiveController::hit_rate_based_policy() {
 
 AdaptiveDecision AdaptiveController::occupancy_based_policy() {
     double occupancy = victim_cache->get_occupancy();
-    VictimStats& stats = victim_cache->get_stats();
+    const VictimMetrics& metrics = victim_cache->get_metrics();
     
-    if (occupancy > OCCUPANCY_THRESHOLD_HIGH) {
-        if (stats.hit_rate > 0.05 || stats.reuse_frequency > 0.1) {
+    if (occupancy > occupancy_high) {
+        if (metrics.hit_window.rate() > 0.05 || metrics.reuse_ewma.get() > 0.1) {
             return DECISION_INCREASE_SIZE;
         }
-    } else if (occupancy < OCCUPANCY_THRESHOLD_LOW) {
+    } else if (occupancy < occupancy_low) {
         return DECISION_DECREASE_SIZE;
     }
     
@@ -57,12 +161,12 @@ AdaptiveDecision AdaptiveController::occupancy_based_policy() {
 
 AdaptiveDecision AdaptiveController::phase_aware_policy() {
     WorkloadPhase phase = phase_detector->get_current_phase();
-    VictimStats& stats = victim_cache->get_stats();
-    double hit_rate = stats.hit_rate;
+    // Growing for a memory-intensive phase only pays if hits last across intervals
+    double hit_rate = victim_cache->get_metrics().hit_rate_ewma.get();
     
     switch (phase) {
         case PHASE_MEMORY_INTENSIVE:
-            if (hit_rate > HIT_RATE_THRESHOLD_LOW) {
+            if (hit_rate > hit_rate_low) {
                 return DECISION_INCREASE_SIZE;
             }
             break;
@@ -105,19 +209,132 @@ AdaptiveDecision AdaptiveController::hybrid_policy() {
     }
 }
 
+AdaptiveDecision AdaptiveController::pid_policy() {
+    const VictimMetrics& metrics = victim_cache->get_metrics();
+    if (metrics.lookups.get() < MRC_MIN_LOOKUPS) {
+        return DECISION_NO_CHANGE;
+    }
+    
+    // Positive error means the cache should grow: hit rate below the
+    // setpoint, or entries filling up faster than the setpoint allows
+    double error = control_target == TARGET_OCCUPANCY ?
+                   victim_cache->get_occupancy() - setpoint :
+                   setpoint - metrics.interval_hit_rate;
+    double derivative = error - pid_prev_error;
+    pid_prev_error = error;
+    
+    if (std::fabs(error) < PID_HYSTERESIS_BAND) {
+        return DECISION_MAINTAIN_SIZE;
+    }
+    // No integration while the dwell holds the size, or the first move after
+    // it would carry every held interval's error (windup)
+    if (instruction_count - last_resize_time < PID_MIN_DWELL) {
+        return DECISION_MAINTAIN_SIZE;
+    }
+    pid_integral += error;
+    
+    double output = PID_KP * error + PID_KI * pid_integral + PID_KD * derivative;
+    int32_t step = (int32_t)std::lround(output / PID_STEP_QUANTUM) * PID_STEP_QUANTUM;
+    step = std::max(-PID_MAX_STEP, std::min(PID_MAX_STEP, step));
+    
+    int32_t current_size = victim_cache->get_current_size();
+    int32_t new_size = std::max((int32_t)MIN_VICTIM_SIZE,
+                                std::min((int32_t)MAX_VICTIM_SIZE, current_size + step));
+    if (new_size == current_size) {
+        // Saturated: stop the integral from winding up against the limit
+        pid_integral -= error;
+        return DECISION_MAINTAIN_SIZE;
+    }
+    
+    target_size = new_size;
+    return DECISION_SET_SIZE;
+}
+
+void AdaptiveController::init_bandit_arms() {
+    // Configured bypass, and a more aggressive one that needs more L2 reuse
+    // and gives up on sequential runs sooner
+    const uint32_t sizes[] = {64, 128, 192, 256};
+    uint32_t aggressive_streaming = std::max(1u, streaming_threshold / 2);
+    for (uint32_t size : sizes) {
+        arms.push_back(BanditArm(size, reuse_threshold, streaming_threshold));
+        arms.push_back(BanditArm(size, reuse_threshold + 1, aggressive_streaming));
+    }
+}
+
+int32_t AdaptiveController::select_arm() const {
+    double total_pulls = 0.0;
+    for (uint32_t i = 0; i < arms.size(); i++) {
+        if (arms[i].pulls == 0) {
+            return i;
+        }
+        total_pulls += arms[i].discounted_pulls;
+    }
+    
+    int32_t best = 0;
+    double best_index = -1e9;
+    for (uint32_t i = 0; i < arms.size(); i++) {
+        double pulls = std::max(arms[i].discounted_pulls, 1e-6);
+        double bonus = BANDIT_EXPLORATION * std::sqrt(2.0 * std::log(std::max(total_pulls, 1.0)) / pulls);
+        double index = arms[i].mean_reward() + bonus;
+        if (index > best_index) {
+            best_index = index;
+            best = i;
+        }
+    }
+    return best;
+}
+
+AdaptiveDecision AdaptiveController::bandit_policy() {
+    if (arms.empty()) {
+        init_bandit_arms();
+    }
+    const VictimMetrics& metrics = victim_cache->get_metrics();
+    if (current_arm >= 0 && metrics.lookups.get() < MRC_MIN_LOOKUPS) {
+        return DECISION_NO_CHANGE;
+    }
+    
+    // Credit the interval that just ended to the arm in force, unless a
+    // memoized restore replaced its configuration in the meantime
+    if (current_arm >= 0) {
+        BanditArm& arm = arms[current_arm];
+        if (victim_cache->get_current_size() == arm.victim_size &&
+            victim_cache->get_reuse_threshold() == arm.reuse_threshold &&
+            victim_cache->get_streaming_threshold() == arm.streaming_threshold) {
+            double reward = metrics.interval_hit_rate - entry_cost * arm.victim_size;
+            for (auto& other : arms) {
+                other.discounted_pulls *= BANDIT_DISCOUNT;
+                other.discounted_reward *= BANDIT_DISCOUNT;
+            }
+            arm.discounted_pulls += 1.0;
+            arm.discounted_reward += reward;
+            arm.pulls++;
+        }
+    }
+    
+    current_arm = select_arm();
+    const BanditArm& next = arms[current_arm];
+    victim_cache->set_reuse_threshold(next.reuse_threshold);
+    victim_cache->set_streaming_threshold(next.streaming_threshold);
+    target_size = next.victim_size;
+    return DECISION_SET_SIZE;
+}
+
 void AdaptiveController::apply_decision(AdaptiveDecision decision) {
     uint32_t current_size = victim_cache->get_current_size();
     uint32_t new_size = current_size;
     
     switch (decision) {
         case DECISION_INCREASE_SIZE:
-            new_size = std::min(current_size + SIZE_ADJUSTMENT_STEP, 
-                               (uint32_t)MAX_VICTIM_SIZE);
+            new_size = std::min(current_size + size_step, (uint32_t)MAX_VICTIM_SIZE);
             break;
             
         case DECISION_DECREASE_SIZE:
-            new_size = std::max(current_size - SIZE_ADJUSTMENT_STEP, 
-                               (uint32_t)MIN_VICTIM_SIZE);
+            new_size = current_size > MIN_VICTIM_SIZE + size_step ?
+                       current_size - size_step : MIN_VICTIM_SIZE;
+            break;
+            
+        case DECISION_SET_SIZE:
+            new_size = target_size;
             break;
             
         case DECISION_MAINTAIN_SIZE:
@@ -128,27 +345,238 @@ void AdaptiveController::apply_decision(AdaptiveDecision decision) {
     
     if (new_size != current_size) {
         victim_cache->resize(new_size);
-        
-        AdaptationHistory record;
-        record.timestamp = instruction_count;
-        record.victim_size = new_size;
-        record.hit_rate = victim_cache->get_stats().hit_rate;
-        record.occupancy = victim_cache->get_occupancy();
-        record.phase = phase_detector->get_current_phase();
-        record.decision = decision;
-        history.push_back(record);
+        record_history(decision, new_size);
         
         std::cout << "[AdaptiveController] Adapted size: " << current_size 
                   << " -> " << new_size << " (decision: " << decision << ")" << std::endl;
     }
 }
 
+void AdaptiveController::record_history(AdaptiveDecision decision, uint32_t new_size) {
+    AdaptationHistory record;
+    record.timestamp = instruction_count;
+    record.victim_size = new_size;
+    record.hit_rate = victim_cache->get_metrics().hit_window.rate();
+    record.occupancy = victim_cache->get_occupancy();
+    record.phase = phase_detector->get_current_phase();
+    record.decision = decision;
+    history.push_back(record);
+}
+
+void AdaptiveController::record_interval(int32_t phase_id) {
+    const VictimMetrics& metrics = victim_cache->get_metrics();
+    if (phase_id < 0 || metrics.lookups.get() < MEMO_MIN_ACCESSES) {
+        return;
+    }
+    
+    double hit_rate = metrics.interval_hit_rate;
+    PhaseConfig& entry = phase_table[phase_id];
+    entry.intervals++;
+    if (entry.intervals == 1 || hit_rate > entry.hit_rate) {
+        entry.victim_size = victim_cache->get_current_size();
+        entry.reuse_threshold = victim_cache->get_reuse_threshold();
+        entry.streaming_threshold = victim_cache->get_streaming_threshold();
+        entry.hit_rate = hit_rate;
+    }
+}
+
+void AdaptiveController::preadapt_for_predicted_phase() {
+    const PhasePredictor& predictor = phase_detector->get_predictor();
+    int32_t next = predictor.predict_next_phase();
+    uint64_t onset = predictor.predict_transition_time();
+    
+    if (next < 0 || onset == 0 || next == active_phase_id || next == preadapted_phase_id) {
+        return;
+    }
+    if (phase_detector->get_instruction_count() + PREDICTION_LEAD_INSTRUCTIONS < onset) {
+        return;
+    }
+    
+    if (restore_phase_config(next, "predicted")) {
+        preadapted_phase_id = next;
+        proactive_adaptations++;
+    }
+}
+
+bool AdaptiveController::restore_phase_config(int32_t phase_id, const char* reason) {
+    auto it = phase_table.find(phase_id);
+    if (it == phase_table.end()) {
+        return false;
+    }
+    
+    const PhaseConfig& memo = it->second;
+    uint32_t current_size = victim_cache->get_current_size();
+    victim_cache->set_reuse_threshold(memo.reuse_threshold);
+    victim_cache->set_streaming_threshold(memo.streaming_threshold);
+    memo_restores++;
+    
+    if (memo.victim_size != current_size) {
+        uint32_t distance = memo.victim_size > current_size ? 
+                            memo.victim_size - current_size : current_size - memo.victim_size;
+        intervals_saved += (distance + size_step - 1) / size_step;
+        victim_cache->resize(memo.victim_size);
+        record_history(DECISION_RESTORE_MEMOIZED, memo.victim_size);
+    }
+    
+    std::cout << "[AdaptiveController] Phase " << phase_id << " " << reason << ": restored size "
+              << current_size << " -> " << memo.victim_size << std::endl;
+    return true;
+}
+
 void AdaptiveController::check_and_adapt() {
-    AdaptiveDecision decision = make_decision();
-    apply_decision(decision);
+    VC_PROFILE_SCOPE(PROF_CONTROLLER_ADAPT);
+    // The interval that just ended ran with the active configuration; score
+    // it before deciding, and before a new phase gets a table entry
+    int32_t phase_id = phase_detector->get_current_phase_id();
+    bool known_phase = phase_table.count(phase_id) > 0;
+    victim_cache->close_metrics_interval();
+    record_interval(phase_id);
+    
+    uint32_t size_before = victim_cache->get_current_size();
+    bool restored = false;
+    if (phase_change_pending) {
+        phase_triggered_adaptations++;
+        pid_integral = 0.0;
+        phase_change_pending = false;
+        if (phase_id != active_phase_id && phase_id == preadapted_phase_id) {
+            // Already running the right configuration; keep it for this interval
+            proactive_confirmed++;
+            restored = true;
+        } else if (phase_id != active_phase_id && known_phase && phase_detector->did_phase_recur()) {
+            restored = restore_phase_config(phase_id, "recurred");
+        }
+    }
+    if (phase_id != active_phase_id) {
+        preadapted_phase_id = -1;
+    }
+    active_phase_id = phase_id;
+    
+    if (!restored) {
+        AdaptiveDecision decision = make_decision();
+        apply_decision(decision);
+    }
+    track_size_move(size_before, victim_cache->get_current_size());
+    
+    // The next MRC decision only looks at lookups from the coming interval
+    mrc_start_hits = victim_cache->get_stack_distance_hits();
+    interval_start_energy = victim_cache->get_energy_stats();
+    interval_start_fills = total_fills();
     last_adaptation_time = instruction_count;
 }
 
+void AdaptiveController::track_size_move(uint32_t old_size, uint32_t new_size) {
+    int32_t direction = new_size > old_size ? 1 : (new_size < old_size ? -1 : 0);
+    if (direction != 0) {
+        if (last_resize_direction != 0 && direction != last_resize_direction) {
+            oscillations++;
+        }
+        last_resize_direction = direction;
+        last_resize_time = instruction_count;
+    }
+    
+    if (direction == move_direction && direction != 0) {
+        move_last_resize = instruction_count;
+        return;
+    }
+    
+    if (move_direction != 0) {
+        move_total += move_last_resize - move_start;
+        size_moves++;
+    }
+    move_direction = direction;
+    if (direction != 0) {
+        uint64_t observed = instruction_count - last_adaptation_time;
+        move_start = instruction_count - std::min<uint64_t>(observed, adaptation_interval);
+        move_last_resize = instruction_count;
+    }
+}
+
+const char* AdaptiveController::policy_name(AdaptationPolicy policy) {
+    switch (policy) {
+        case POLICY_MRC: return "mrc";
+        case POLICY_PID: return "pid";
+        case POLICY_BANDIT: return "bandit";
+        case POLICY_HYBRID:
+        default: return "hybrid";
+    }
+}
+
+const char* AdaptiveController::objective_name(AdaptationObjective objective) {
+    return objective == OBJECTIVE_EDP ? "edp" : "hit-rate";
+}
+
+bool AdaptiveController::parse_objective(const std::string& name, AdaptationObjective& objective) {
+    if (name == "hit-rate") {
+        objective = OBJECTIVE_HIT_RATE;
+    } else if (name == "edp") {
+        objective = OBJECTIVE_EDP;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool AdaptiveController::parse_policy(const std::string& name, AdaptationPolicy& policy) {
+    if (name == "hybrid") {
+        policy = POLICY_HYBRID;
+    } else if (name == "mrc") {
+        policy = POLICY_MRC;
+    } else if (name == "pid") {
+        policy = POLICY_PID;
+    } else if (name == "bandit") {
+        policy = POLICY_BANDIT;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void AdaptiveController::print_phase_table() const {
+    std::cout << "\n=== Phase Configuration Table ===" << std::endl;
+    std::cout << std::setw(8) << "Phase"
+              << std::setw(10) << "Size"
+              << std::setw(8) << "Reuse"
+              << std::setw(8) << "Stream"
+              << std::setw(12) << "Hit Rate"
+              << std::setw(12) << "Intervals" << std::endl;
+    std::cout << std::string(58, '-') << std::endl;
+    
+    for (const auto& item : phase_table) {
+        const PhaseConfig& memo = item.second;
+        std::cout << std::setw(8) << item.first
+                  << std::setw(10) << memo.victim_size
+                  << std::setw(8) << memo.reuse_threshold
+                  << std::setw(8) << memo.streaming_threshold
+                  << std::setw(11) << std::fixed << std::setprecision(2)
+                  << (memo.hit_rate * 100) << "%"
+                  << std::setw(12) << memo.intervals << std::endl;
+    }
+    std::cout << "Restores: " << memo_restores << ", adaptation intervals saved: "
+              << intervals_saved << std::endl;
+    std::cout << "=================================\n" << std::endl;
+}
+
+void AdaptiveController::print_bandit_arms() const {
+    std::cout << "\n=== Bandit Arms ===" << std::endl;
+    std::cout << std::setw(8) << "Size"
+              << std::setw(8) << "Reuse"
+              << std::setw(8) << "Stream"
+              << std::setw(10) << "Pulls"
+              << std::setw(14) << "Mean Reward" << std::endl;
+    std::cout << std::string(48, '-') << std::endl;
+    
+    for (uint32_t i = 0; i < arms.size(); i++) {
+        const BanditArm& arm = arms[i];
+        std::cout << std::setw(8) << arm.victim_size
+                  << std::setw(8) << arm.reuse_threshold
+                  << std::setw(8) << arm.streaming_threshold
+                  << std::setw(10) << arm.pulls
+                  << std::setw(14) << std::fixed << std::setprecision(4) << arm.mean_reward()
+                  << ((int32_t)i == current_arm ? "  <- current" : "") << std::endl;
+    }
+    std::cout << "===================\n" << std::endl;
+}
+
 void AdaptiveController::print_adaptation_history() const {
     std::cout << "\n=== Adaptation History ===" << std::endl;
     std::cout << std::setw(12) << "Timestamp" 
@@ -158,8 +586,12 @@ void AdaptiveController::print_adaptation_history() const {
               << std::setw(15) << "Phase"
               << std::setw(10) << "Decision" << std::endl;
     std::cout << std::string(70, '-') << std::endl;
+    if (history.total() > history.size()) {
+        std::cout << "(last " << history.size() << " of " << history.total() << " adaptations)" << std::endl;
+    }
     
-    for (const auto& record : history) {
+    for (size_t i = 0; i < history.size(); i++) {
+        const AdaptationHistory& record = history[i];
         std::cout << std::setw(12) << record.timestamp
                   << std::setw(10) << record.victim_size
                   << std::setw(11) << std::fixed << std::setprecision(2) 
@@ -179,6 +611,8 @@ void AdaptiveController::print_adaptation_history() const {
             case DECISION_INCREASE_SIZE: std::cout << "INCREASE"; break;
             case DECISION_DECREASE_SIZE: std::cout << "DECREASE"; break;
             case DECISION_MAINTAIN_SIZE: std::cout << "MAINTAIN"; break;
+            case DECISION_RESTORE_MEMOIZED: std::cout << "RESTORE"; break;
+            case DECISION_SET_SIZE: std::cout << "SET"; break;
             default: std::cout << "NO_CHANGE"; break;
         }
         std::cout << std::endl;
@@ -194,7 +628,8 @@ void AdaptiveController::export_results(const std::string& filename) const {
     }
     
     outfile << "timestamp,victim_size,hit_rate,occupancy,phase,decision\n";
-    for (const auto& record : history) {
+    for (size_t i = 0; i < history.size(); i++) {
+        const AdaptationHistory& record = history[i];
         outfile << record.timestamp << ","
                 << record.victim_size << ","
                 << record.hit_rate << ","
@@ -5,19 +5,61 @@
 #include "../monitoring/phase_detector.h"
 #include <cstdint>
 #include <string>
+#include <map>
 
-#define ADAPTATION_INTERVAL 50000
-#define SIZE_ADJUSTMENT_STEP 32
-#define HIT_RATE_THRESHOLD_HIGH 0.08
-#define HIT_RATE_THRESHOLD_LOW 0.02
-#define OCCUPANCY_THRESHOLD_HIGH 0.75
-#define OCCUPANCY_THRESHOLD_LOW 0.30
+#define MEMO_MIN_ACCESSES 1000
+#define PREDICTION_LEAD_INSTRUCTIONS 25000
+#define MRC_ENTRY_COST 0.0002
+#define MRC_MIN_LOOKUPS 1000
+#define EDP_MISS_PENALTY_CYCLES 14
+
+// PID gains are in entries per unit of error (hit rate or occupancy)
+#define PID_KP 400.0
+#define PID_KI 100.0
+#define PID_KD 100.0
+#define PID_HIT_RATE_SETPOINT 0.25
+#define PID_OCCUPANCY_SETPOINT 0.90
+#define PID_HYSTERESIS_BAND 0.02
+#define PID_MIN_DWELL 100000
+#define PID_STEP_QUANTUM 8
+#define PID_MAX_STEP 96
+
+// The bandit needs many pulls, so it decides on a shorter interval. Rewards
+// are discounted by BANDIT_DISCOUNT per pull (~20-pull memory) to follow drift
+#define BANDIT_INTERVAL 10000
+#define BANDIT_DISCOUNT 0.95
+#define BANDIT_EXPLORATION 0.1
+
+// HYBRID votes one size step per interval; MRC reads the
+// stack-distance histogram and jumps straight to the best size; PID steers
+// the interval hit rate or occupancy towards a setpoint; BANDIT learns which
+// size/bypass combination pays best with discounted UCB
+enum AdaptationPolicy {
+    POLICY_HYBRID,
+    POLICY_MRC,
+    POLICY_PID,
+    POLICY_BANDIT
+};
+
+// What the MRC policy optimizes: hit rate net of a per-entry cost, or the
+// modeled energy-delay product of the victim cache
+enum AdaptationObjective {
+    OBJECTIVE_HIT_RATE,
+    OBJECTIVE_EDP
+};
+
+enum ControlTarget {
+    TARGET_HIT_RATE,
+    TARGET_OCCUPANCY
+};
 
 enum AdaptiveDecision {
     DECISION_INCREASE_SIZE,
     DECISION_DECREASE_SIZE,
     DECISION_MAINTAIN_SIZE,
-    DECISION_NO_CHANGE
+    DECISION_NO_CHANGE,
+    DECISION_RESTORE_MEMOIZED,
+    DECISION_SET_SIZE
 };
 
 struct AdaptationHistory {
@@ -33,14 +75,104 @@ struct AdaptationHistory {
                          decision(DECISION_NO_CHANGE) {}
 };
 
+// Best configuration seen for one working-set phase, scored by the victim
+// hit rate of the adaptation intervals that ran with it
+struct PhaseConfig {
+    uint32_t victim_size;
+    uint32_t reuse_threshold;
+    uint32_t streaming_threshold;
+    double hit_rate;
+    uint64_t intervals;
+    
+    PhaseConfig() : victim_size(0), reuse_threshold(0), streaming_threshold(0),
+                    hit_rate(0.0), intervals(0) {}
+};
+
+// One bandit arm: a victim size with a bypass setting. Pulls and reward are
+// discounted sums, so an arm left alone regains its exploration bonus
+struct BanditArm {
+    uint32_t victim_size;
+    uint32_t reuse_threshold;
+    uint32_t streaming_threshold;
+    double discounted_pulls;
+    double discounted_reward;
+    uint64_t pulls;
+    
+    BanditArm(uint32_t size = 0, uint32_t reuse = 0, uint32_t streaming = 0)
+        : victim_size(size), reuse_threshold(reuse), streaming_threshold(streaming),
+          discounted_pulls(0.0), discounted_reward(0.0), pulls(0) {}
+    
+    double mean_reward() const {
+        return discounted_pulls > 0.0 ? discounted_reward / discounted_pulls : 0.0;
+    }
+};
+
 class AdaptiveController {
 private:
     VictimCache* victim_cache;
     PhaseDetector* phase_detector;
     
+    uint64_t adaptation_interval;
+    uint32_t size_step;
+    double hit_rate_high;
+    double hit_rate_low;
+    double occupancy_high;
+    double occupancy_low;
+    // Configured bypass thresholds the bandit arms are built around
+    uint32_t reuse_threshold;
+    uint32_t streaming_threshold;
+    
     uint64_t last_adaptation_time;
     uint64_t instruction_count;
-    std::vector<AdaptationHistory> history;
+    BoundedHistory<AdaptationHistory> history;
+    bool phase_change_pending;
+    uint64_t phase_triggered_adaptations;
+    
+    std::map<int32_t, PhaseConfig> phase_table;
+    int32_t active_phase_id;
+    uint64_t memo_restores;
+    uint64_t intervals_saved;
+    
+    bool proactive;
+    int32_t preadapted_phase_id;
+    uint64_t proactive_adaptations;
+    uint64_t proactive_confirmed;
+    
+    AdaptationPolicy policy;
+    double entry_cost;
+    std::vector<uint64_t> mrc_start_hits;
+    uint32_t target_size;
+    
+    AdaptationObjective objective;
+    uint32_t miss_penalty_cycles;
+    EnergyStats interval_start_energy;
+    uint64_t interval_start_fills;
+    
+    ControlTarget control_target;
+    double setpoint;
+    double pid_integral;
+    double pid_prev_error;
+    uint64_t last_resize_time;
+    int32_t last_resize_direction;
+    uint64_t oscillations;
+    
+    std::vector<BanditArm> arms;
+    int32_t current_arm;
+    
+    // A size move is a run of consecutive resizes in one direction; it takes
+    // from the interval before its first resize to its last one
+    int32_t move_direction;
+    uint64_t move_start;
+    uint64_t move_last_resize;
+    uint64_t move_total;
+    uint64_t size_moves;
+    
+    void record_interval(int32_t phase_id);
+    bool restore_phase_config(int32_t phase_id, const char* reason);
+    void preadapt_for_predicted_phase();
+    void record_history(AdaptiveDecision decision, uint32_t new_size);
+    // Only the MRC policy and the EDP objective read the stack distances
+    void update_stack_distance_tracking();
     
     AdaptiveDecision make_decision();
     void apply_decision(AdaptiveDecision decision);
@@ -49,21 +181,83 @@ private:
     AdaptiveDecision occupancy_based_policy();
     AdaptiveDecision phase_aware_policy();
     AdaptiveDecision hybrid_policy();
+    AdaptiveDecision pid_policy();
+    AdaptiveDecision bandit_policy();
+    void init_bandit_arms();
+    int32_t select_arm() const;
     
     bool should_adapt() const;
     uint32_t calculate_optimal_size();
+    double estimate_interval_edp(uint32_t size, uint64_t hits, uint64_t current_hits,
+                                 uint64_t lookups) const;
+    uint64_t total_fills() const;
+    void track_size_move(uint32_t old_size, uint32_t new_size);
 
 public:
-    AdaptiveController(VictimCache* vc, PhaseDetector* pd);
+    AdaptiveController(VictimCache* vc, PhaseDetector* pd, const SimConfig& config = SimConfig());
     
     void update(uint64_t instructions);
     void check_and_adapt();
     
-    void set_victim_cache(VictimCache* vc) { victim_cache = vc; }
+    // A working-set shift makes the next update() re-evaluate immediately
+    // instead of waiting out the rest of the adaptation interval
+    void notify_phase_change() { phase_change_pending = true; }
+    uint64_t get_phase_triggered_adaptations() const { return phase_triggered_adaptations; }
+    
+    // On a recurring phase the memoized configuration is applied in one
+    // step; intervals_saved counts the size_step moves skipped
+    uint64_t get_memo_restores() const { return memo_restores; }
+    uint64_t get_intervals_saved() const { return intervals_saved; }
+    const std::map<int32_t, PhaseConfig>& get_phase_table() const { return phase_table; }
+    
+    // Proactive mode applies the memoized configuration of the predicted next
+    // phase PREDICTION_LEAD_INSTRUCTIONS before its predicted onset
+    void set_proactive(bool enable) { proactive = enable; }
+    uint64_t get_proactive_adaptations() const { return proactive_adaptations; }
+    uint64_t get_proactive_confirmed() const { return proactive_confirmed; }
+    void print_phase_table() const;
+    
+    // MRC policy: a size is worth its entries while each one adds at least
+    // entry_cost to the victim hit rate
+    void set_policy(AdaptationPolicy new_policy) { policy = new_policy; update_stack_distance_tracking(); }
+    AdaptationPolicy get_policy() const { return policy; }
+    void set_entry_cost(double cost) { entry_cost = cost; }
+    double get_entry_cost() const { return entry_cost; }
+    // PID policy: errors inside PID_HYSTERESIS_BAND are ignored and the size
+    // is held at least PID_MIN_DWELL instructions after every resize
+    void set_setpoint(ControlTarget target, double value) { control_target = target; setpoint = value; }
+    ControlTarget get_control_target() const { return control_target; }
+    double get_setpoint() const { return setpoint; }
+    // EDP objective: each hit lost against the current size is charged
+    // miss_penalty cycles (the L2 access that replaces it)
+    void set_objective(AdaptationObjective new_objective) { objective = new_objective; update_stack_distance_tracking(); }
+    AdaptationObjective get_objective() const { return objective; }
+    void set_miss_penalty(uint32_t cycles) { miss_penalty_cycles = cycles; }
+    static const char* policy_name(AdaptationPolicy policy);
+    static bool parse_policy(const std::string& name, AdaptationPolicy& policy);
+    static const char* objective_name(AdaptationObjective objective);
+    static bool parse_objective(const std::string& name, AdaptationObjective& objective);
+    
+    const std::vector<BanditArm>& get_bandit_arms() const { return arms; }
+    void print_bandit_arms() const;
+    
+    // A resize in the opposite direction of the previous one
+    uint64_t get_oscillations() const { return oscillations; }
+    uint64_t get_size_moves() const { return size_moves; }
+    double get_mean_move_time() const {
+        return size_moves > 0 ? (double)move_total / size_moves : 0.0;
+    }
+    
+    void set_victim_cache(VictimCache* vc) { victim_cache = vc; update_stack_distance_tracking(); }
     void set_phase_detector(PhaseDetector* pd) { phase_detector = pd; }
     
     void print_adaptation_history() const;
-    std::vector<AdaptationHistory> get_history() const { return history; }
+    // The last METRICS_HISTORY_LENGTH resizes; get_adaptations() counts all of them
+    std::vector<AdaptationHistory> get_history() const { return history.to_vector(); }
+    uint64_t get_adaptations() const { return history.total(); }
+    const AdaptationHistory* get_last_adaptation() const {
+        return history.empty() ? nullptr : &history.back();
+    }
     
     void export_results(const std::string& filename) const;
 };
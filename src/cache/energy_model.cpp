@@ -0,0 +1,28 @@
+#include "energy_model.h"
+#include <iostream>
+#include <iomanip>
+
+double EnergyModel::estimate_energy(uint32_t active, uint32_t powered, uint64_t lookups, uint64_t hits,
+                                    uint64_t fills, uint64_t cycles, uint32_t woken) const {
+    return lookups * lookup_energy(active) +
+           hits * read_energy() +
+           fills * write_energy() +
+           leakage_energy(powered, cycles) +
+           wakeup_energy(woken);
+}
+
+void EnergyModel::print_stats(const EnergyStats& stats) const {
+    std::cout << "\n=== Victim Cache Energy ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  Tag Search: " << (stats.lookup_pj / 1000.0) << " nJ" << std::endl;
+    std::cout << "  Data Read/Write: " << (stats.data_pj / 1000.0) << " nJ" << std::endl;
+    std::cout << "  Leakage: " << (stats.leakage_pj / 1000.0) << " nJ over "
+              << stats.cycles << " cycles" << std::endl;
+    std::cout << "  Wake-up: " << (stats.wakeup_pj / 1000.0) << " nJ ("
+              << stats.entries_woken << " entries powered back on)" << std::endl;
+    std::cout << "  Power Gating: " << stats.gate_events << " shrinks gated "
+              << stats.entries_gated << " entries" << std::endl;
+    std::cout << "  Total: " << (stats.total_pj() / 1000.0) << " nJ" << std::endl;
+    std::cout << "  Energy-Delay Product: " << std::scientific << std::setprecision(3)
+              << stats.edp() << " pJ*cycles" << std::fixed << std::endl;
+}
@@ -0,0 +1,79 @@
+#ifndef ENERGY_MODEL_H
+#define ENERGY_MODEL_H
+
+#include <cstdint>
+
+// Per-event energies in picojoules, in the spirit of a CACTI sweep for a
+// small fully-associative array of 64B lines. The tag search is a CAM match
+// over every active entry, so lookups cost more in a larger cache.
+#define ENERGY_LOOKUP_BASE_PJ 1.0
+#define ENERGY_LOOKUP_PER_ENTRY_PJ 0.04
+#define ENERGY_READ_PJ 4.0
+#define ENERGY_WRITE_PJ 5.0
+#define ENERGY_LEAKAGE_PJ_PER_ENTRY_CYCLE 0.0005
+#define ENERGY_WAKEUP_PJ_PER_ENTRY 2.0
+
+struct EnergyParams {
+    double lookup_base_pj;
+    double lookup_per_entry_pj;
+    double read_pj;
+    double write_pj;
+    double leakage_pj_per_entry_cycle;
+    double wakeup_pj_per_entry;
+
+    EnergyParams() : lookup_base_pj(ENERGY_LOOKUP_BASE_PJ),
+                     lookup_per_entry_pj(ENERGY_LOOKUP_PER_ENTRY_PJ),
+                     read_pj(ENERGY_READ_PJ), write_pj(ENERGY_WRITE_PJ),
+                     leakage_pj_per_entry_cycle(ENERGY_LEAKAGE_PJ_PER_ENTRY_CYCLE),
+                     wakeup_pj_per_entry(ENERGY_WAKEUP_PJ_PER_ENTRY) {}
+};
+
+struct EnergyStats {
+    double lookup_pj;
+    double data_pj;
+    double leakage_pj;
+    double wakeup_pj;
+    uint64_t cycles;
+    uint64_t gate_events;
+    uint64_t entries_gated;
+    uint64_t entries_woken;
+
+    EnergyStats() : lookup_pj(0.0), data_pj(0.0), leakage_pj(0.0), wakeup_pj(0.0), cycles(0),
+                    gate_events(0), entries_gated(0), entries_woken(0) {}
+
+    double dynamic_pj() const { return lookup_pj + data_pj + wakeup_pj; }
+    double total_pj() const { return dynamic_pj() + leakage_pj; }
+
+    // Energy-delay product in pJ * cycles
+    double edp() const { return total_pj() * cycles; }
+};
+
+class EnergyModel {
+private:
+    EnergyParams params;
+
+public:
+    EnergyModel(const EnergyParams& energy_params = EnergyParams()) : params(energy_params) {}
+
+    double lookup_energy(uint32_t active_entries) const {
+        return params.lookup_base_pj + params.lookup_per_entry_pj * active_entries;
+    }
+    double read_energy() const { return params.read_pj; }
+    double write_energy() const { return params.write_pj; }
+    double leakage_energy(uint32_t powered_entries, uint64_t cycles) const {
+        return params.leakage_pj_per_entry_cycle * powered_entries * cycles;
+    }
+    double wakeup_energy(uint32_t entries) const { return params.wakeup_pj_per_entry * entries; }
+
+    const EnergyParams& get_params() const { return params; }
+    void set_params(const EnergyParams& energy_params) { params = energy_params; }
+
+    // Modeled energy of an interval run with `active` entries searched and
+    // `powered` entries leaking for `cycles`, waking `woken` entries first
+    double estimate_energy(uint32_t active, uint32_t powered, uint64_t lookups, uint64_t hits,
+                           uint64_t fills, uint64_t cycles, uint32_t woken) const;
+
+    void print_stats(const EnergyStats& stats) const;
+};
+
+#endif
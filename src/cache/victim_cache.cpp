@@ -1,21 +1,35 @@
 #include "victim_cache.h"
+#include "../monitoring/profiler.h"
 #include <iostream>
 #include <iomanip>
 #include <cstring>
 #include <algorithm>
+#include <cstdlib>
 
-VictimCache::VictimCache(uint32_t size) 
-    : current_size(size), max_size(MAX_VICTIM_SIZE), global_lru_counter(0),
-      last_sequential_addr(0), sequential_count(0) {
+#ifdef VC_DEBUG_CHECKS
+#define VC_CHECK_CONSISTENCY() do { if (!check_consistency()) std::abort(); } while (0)
+#else
+#define VC_CHECK_CONSISTENCY() do {} while (0)
+#endif
+
+VictimCache::VictimCache(uint32_t size, const SimConfig& config) 
+    : current_size(size), max_size(std::max<uint32_t>(size, MAX_VICTIM_SIZE)), global_lru_counter(0),
+      last_sequential_addr(0), sequential_count(0), spill_clean_blocks(false),
+      reuse_threshold(config.reuse_threshold), streaming_threshold(config.streaming_threshold),
+      bypass_dueling(false), psel(DUEL_PSEL_MAX / 2), track_stack_distance(false),
+      power_gating(true), verbose(true), valid_entries(0), dirty_entries(0), prefetched_entries(0) {
     entries.resize(max_size);
     access_history.reserve(1000);
     reuse_counters.resize(10000, 0);
+    stack_distance_hits.resize(MRC_NUM_BUCKETS, 0);
     std::cout << "[VictimCache] Initialized with " << current_size << " entries (SMART INSERTION ENABLED)" << std::endl;
 }
 
 VictimCache::~VictimCache() {
-    std::cout << "[VictimCache] Final statistics:" << std::endl;
-    print_stats();
+    if (verbose) {
+        std::cout << "[VictimCache] Final statistics:" << std::endl;
+        print_stats();
+    }
 }
 
 uint32_t VictimCache::find_lru_way() {
@@ -34,47 +48,285 @@ uint32_t VictimCache::find_lru_way() {
     return lru_way;
 }
 
+void VictimCache::set_valid(uint32_t way, bool valid) {
+    if (entries[way].valid != valid) {
+        valid ? valid_entries++ : valid_entries--;
+        entries[way].valid = valid;
+        stats.occupancy_rate = (double)valid_entries / current_size;
+    }
+}
+
+void VictimCache::set_dirty(uint32_t way, bool dirty) {
+    if (entries[way].dirty != dirty) {
+        dirty ? dirty_entries++ : dirty_entries--;
+        entries[way].dirty = dirty;
+    }
+}
+
+void VictimCache::set_prefetched(uint32_t way, bool prefetched) {
+    if (entries[way].prefetched != prefetched) {
+        prefetched ? prefetched_entries++ : prefetched_entries--;
+        entries[way].prefetched = prefetched;
+    }
+}
+
 void VictimCache::update_lru(uint32_t way) {
     entries[way].lru_counter = global_lru_counter++;
 }
 
-int32_t VictimCache::find_victim_entry(uint64_t address) {
+int32_t VictimCache::find_victim_entry(uint64_t address) const {
+    VC_PROFILE_SCOPE(PROF_FIND_VICTIM_ENTRY);
     for (uint32_t i = 0; i < current_size; i++) {
         if (entries[i].valid && entries[i].address == address) {
+            VC_PROFILE_COUNT(PROF_VICTIM_ENTRIES_SCANNED, i + 1);
+            return i;
+        }
+    }
+    VC_PROFILE_COUNT(PROF_VICTIM_ENTRIES_SCANNED, current_size);
+    return -1;
+}
+
+int32_t VictimCache::shadow_depth(uint64_t address) const {
+    for (uint32_t i = 0; i < shadow_stack.size(); i++) {
+        if (shadow_stack[i] == address) {
             return i;
         }
     }
     return -1;
 }
 
+void VictimCache::shadow_touch(uint64_t address) {
+    if (!track_stack_distance) {
+        return;
+    }
+    int32_t depth = shadow_depth(address);
+    if (depth < 0) {
+        if (shadow_stack.size() < MAX_VICTIM_SIZE) {
+            shadow_stack.push_back(address);
+        }
+        depth = shadow_stack.size() - 1;
+    }
+    shadow_promote(depth, address);
+}
+
+// Shifts everything above `depth` down one and puts the address on top
+void VictimCache::shadow_promote(int32_t depth, uint64_t address) {
+    std::copy_backward(shadow_stack.begin(), shadow_stack.begin() + depth,
+                       shadow_stack.begin() + depth + 1);
+    shadow_stack[0] = address;
+}
+
+void VictimCache::shadow_remove(uint64_t address) {
+    if (!track_stack_distance) {
+        return;
+    }
+    int32_t depth = shadow_depth(address);
+    if (depth >= 0) {
+        shadow_stack.erase(shadow_stack.begin() + depth);
+    }
+}
+
+void VictimCache::set_stack_distance_tracking(bool enable) {
+    if (enable && !track_stack_distance) {
+        shadow_stack.reserve(MAX_VICTIM_SIZE);
+    } else if (!enable) {
+        std::vector<uint64_t>().swap(shadow_stack);
+    }
+    track_stack_distance = enable;
+}
+
+bool VictimCache::take_ghost(uint64_t address) {
+    return flushed_ghosts.erase(address) > 0;
+}
+
 void VictimCache::invalidate_entry(uint32_t way) {
-    entries[way].valid = false;
+    set_valid(way, false);
     entries[way].access_count = 0;
+    set_prefetched(way, false);
+    set_dirty(way, false);
 }
 
-bool VictimCache::lookup(uint64_t address) {
+void VictimCache::spill_entry(uint32_t way) {
+    if (!entries[way].valid) {
+        return;
+    }
+    if (entries[way].dirty) {
+        pending_spills.push_back(VictimSpill(entries[way].address, true));
+        stats.writebacks++;
+        set_dirty(way, false);
+    } else if (spill_clean_blocks) {
+        pending_spills.push_back(VictimSpill(entries[way].address, false));
+    }
+}
+
+void VictimCache::take_spills(std::vector<VictimSpill>& out) {
+    out.clear();
+    out.swap(pending_spills);
+}
+
+void VictimCache::swap(uint64_t hit_address, uint64_t incoming_address, bool incoming_dirty,
+                       uint32_t incoming_access_count) {
+    int32_t way = find_victim_entry(hit_address);
+    if (way < 0) {
+        return;
+    }
+    
+    stats.swaps++;
+    invalidate_entry(way);
+    shadow_remove(hit_address);
+    if (incoming_address == hit_address) {
+        VC_CHECK_CONSISTENCY();
+        return;
+    }
+    shadow_touch(incoming_address);
+    
+    int32_t existing_way = find_victim_entry(incoming_address);
+    if (existing_way >= 0) {
+        set_dirty(existing_way, entries[existing_way].dirty || incoming_dirty);
+        update_lru(existing_way);
+        VC_CHECK_CONSISTENCY();
+        return;
+    }
+    
+    energy.data_pj += energy_model.write_energy();
+    entries[way].address = incoming_address;
+    entries[way].tag = incoming_address / BLOCK_SIZE;
+    set_valid(way, true);
+    entries[way].insertion_time = global_lru_counter;
+    entries[way].access_count = incoming_access_count;
+    entries[way].reuse_distance = 0;
+    entries[way].high_reuse_block = (incoming_access_count >= reuse_threshold);
+    set_prefetched(way, false);
+    set_dirty(way, incoming_dirty);
+    update_lru(way);
+    VC_CHECK_CONSISTENCY();
+}
+
+bool VictimCache::invalidate(uint64_t address, bool* was_dirty) {
+    int32_t way = find_victim_entry(address);
+    if (way < 0) {
+        return false;
+    }
+    
+    if (was_dirty) {
+        *was_dirty = entries[way].dirty;
+    }
+    stats.invalidations++;
+    invalidate_entry(way);
+    shadow_remove(address);
+    VC_CHECK_CONSISTENCY();
+    return true;
+}
+
+void VictimCache::get_resident_addresses(std::vector<uint64_t>& out) const {
+    out.clear();
+    for (uint32_t i = 0; i < current_size; i++) {
+        if (entries[i].valid) {
+            out.push_back(entries[i].address);
+        }
+    }
+}
+
+bool VictimCache::lookup(uint64_t address, bool* was_prefetched, bool* was_dirty) {
+    VC_PROFILE_SCOPE(PROF_VICTIM_LOOKUP);
     stats.total_accesses++;
+    energy.lookup_pj += energy_model.lookup_energy(current_size);
+    
+    if (track_stack_distance) {
+        int32_t depth = shadow_depth(address);
+        if (depth >= 0) {
+            stack_distance_hits[depth / MRC_BUCKET_SIZE]++;
+            shadow_promote(depth, address);
+        }
+    }
+    
+    if (bypass_dueling && stats.total_accesses % DUEL_SAMPLE_INTERVAL == 0) {
+        stats.psel_history.push_back(psel);
+    }
     
     int32_t way = find_victim_entry(address);
+    metrics.hit_window.add(way >= 0);
     if (way >= 0) {
         stats.victim_hits++;
+        stats.update_rates(current_size);
+        energy.data_pj += energy_model.read_energy();
+        if (was_prefetched) {
+            *was_prefetched = entries[way].prefetched;
+        }
+        if (entries[way].prefetched) {
+            stats.prefetch_hits++;
+            set_prefetched(way, false);
+        }
+        // The refilled L1 copy takes over ownership of the modified data
+        if (was_dirty) {
+            *was_dirty = entries[way].dirty;
+            set_dirty(way, false);
+        }
         entries[way].access_count++;
         update_lru(way);
+        VC_CHECK_CONSISTENCY();
         return true;
     }
     
     stats.victim_misses++;
+    stats.update_rates(current_size);
+    if (bypass_dueling) {
+        train_psel(address);
+    }
+    if (!flushed_ghosts.empty() && take_ghost(address)) {
+        stats.churn_misses++;
+    }
     return false;
 }
+int32_t VictimCache::duel_leader(uint64_t address) const {
+    uint64_t block = address / BLOCK_SIZE;
+    uint32_t group = (block * 0x9E3779B97F4A7C15ULL) >> (64 - DUEL_CONSTITUENCY_BITS);
+    switch (group % DUEL_LEADER_STRIDE) {
+        case 0: return BYPASS_CONFIGURED;
+        case 1: return BYPASS_LENIENT;
+        default: return -1;
+    }
+}
+
+BypassPolicy VictimCache::bypass_policy_for(uint64_t address) const {
+    int32_t leader = duel_leader(address);
+    return leader >= 0 ? (BypassPolicy)leader : get_follower_policy();
+}
+
+// A miss in a leader group counts against that group's policy
+void VictimCache::train_psel(uint64_t address) {
+    int32_t leader = duel_leader(address);
+    if (leader < 0) {
+        return;
+    }
+    
+    BypassPolicy before = get_follower_policy();
+    if (leader == BYPASS_CONFIGURED && psel < DUEL_PSEL_MAX) {
+        psel++;
+    } else if (leader == BYPASS_LENIENT && psel > 0) {
+        psel--;
+    }
+    if (get_follower_policy() != before) {
+        stats.duel_switches++;
+    }
+}
+
 bool VictimCache::should_insert(uint64_t address, uint32_t l2_access_count) {
-    if (is_streaming_access(address)) {
+    uint32_t reuse_limit = reuse_threshold;
+    uint32_t streaming_limit = streaming_threshold;
+    if (bypass_dueling && bypass_policy_for(address) == BYPASS_LENIENT) {
+        reuse_limit = DUEL_ALT_REUSE_THRESHOLD;
+        streaming_limit = DUEL_ALT_STREAMING_THRESHOLD;
+    }
+    
+    if (is_streaming_access(address, streaming_limit)) {
         stats.bypassed_insertions++;
         return false;
     }
     
     uint32_t reuse_score = predict_reuse_potential(address);
     
-    if (l2_access_count >= REUSE_PREDICTION_THRESHOLD || reuse_score >= 2) {
+    if (l2_access_count >= reuse_limit || reuse_score >= 2) {
         return true;
     }
     
@@ -82,10 +334,10 @@ bool VictimCache::should_insert(uint64_t address, uint32_t l2_access_count) {
     return false;
 }
 
-bool VictimCache::is_streaming_access(uint64_t address) {
+bool VictimCache::is_streaming_access(uint64_t address, uint32_t threshold) {
     if (address == last_sequential_addr + BLOCK_SIZE) {
         sequential_count++;
-        if (sequential_count > BYPASS_STREAMING_THRESHOLD) {
+        if (sequential_count > threshold) {
             last_sequential_addr = address;
             return true;
         }
@@ -107,6 +359,7 @@ void VictimCache::update_access_history(uint64_t address) {
 }
 
 uint32_t VictimCache::predict_reuse_potential(uint64_t address) {
+    VC_PROFILE_SCOPE(PROF_PREDICT_REUSE);
     uint32_t reuse_count = 0;
     uint32_t idx = (address / BLOCK_SIZE) % reuse_counters.size();
     
@@ -126,41 +379,102 @@ uint32_t VictimCache::predict_reuse_potential(uint64_t address) {
 void VictimCache::insert(uint64_t address, uint64_t tag, uint8_t* data) {
     insert_smart(address, tag, data, 0);
 }
-void VictimCache::insert_smart(uint64_t address, uint64_t tag, uint8_t* data, uint32_t access_count) {
+bool VictimCache::insert_smart(uint64_t address, uint64_t tag, uint8_t* data, uint32_t access_count,
+                               bool dirty) {
+    VC_PROFILE_SCOPE(PROF_VICTIM_INSERT);
     update_access_history(address);
     
+    int32_t existing_way = find_victim_entry(address);
+    
     if (!should_insert(address, access_count)) {
-        return;
+        // A bypassed dirty block still has to reach the next level, and a stale
+        // copy left behind would now be out of date
+        if (dirty || spill_clean_blocks) {
+            if (existing_way >= 0) {
+                invalidate_entry(existing_way);
+            }
+            shadow_remove(address);
+            pending_spills.push_back(VictimSpill(address, dirty));
+            if (dirty) {
+                stats.writebacks++;
+            }
+        }
+        VC_CHECK_CONSISTENCY();
+        return false;
     }
     
     stats.victim_insertions++;
+    stats.update_rates(current_size);
+    if (dirty) {
+        stats.dirty_insertions++;
+    }
+    shadow_touch(address);
+    if (!flushed_ghosts.empty()) {
+        take_ghost(address);
+    }
     
-    int32_t existing_way = find_victim_entry(address);
     if (existing_way >= 0) {
         update_lru(existing_way);
         entries[existing_way].access_count++;
         entries[existing_way].high_reuse_block = true;
+        set_dirty(existing_way, entries[existing_way].dirty || dirty);
         stats.predicted_reuses++;
-        return;
+        VC_CHECK_CONSISTENCY();
+        return true;
     }
     
     uint32_t victim_way = find_lru_way();
     
     if (entries[victim_way].valid) {
         stats.victim_evictions++;
+        spill_entry(victim_way);
     }
     
+    energy.data_pj += energy_model.write_energy();
     entries[victim_way].address = address;
     entries[victim_way].tag = tag;
     if (data) {
         memcpy(entries[victim_way].data, data, BLOCK_SIZE);
     }
-    entries[victim_way].valid = true;
+    set_valid(victim_way, true);
     entries[victim_way].insertion_time = global_lru_counter;
     entries[victim_way].access_count = access_count;
     entries[victim_way].reuse_distance = 0;
-    entries[victim_way].high_reuse_block = (access_count >= REUSE_PREDICTION_THRESHOLD);
+    entries[victim_way].high_reuse_block = (access_count >= reuse_threshold);
+    set_prefetched(victim_way, false);
+    set_dirty(victim_way, dirty);
     update_lru(victim_way);
+    VC_CHECK_CONSISTENCY();
+    return true;
+}
+
+// Prefetch-buffer mode: prefetched blocks skip the reuse filter and the
+// demand access history, and sit at MRU until demanded or aged out.
+void VictimCache::insert_prefetch(uint64_t address) {
+    if (find_victim_entry(address) >= 0) {
+        return;
+    }
+    
+    uint32_t victim_way = find_lru_way();
+    if (entries[victim_way].valid) {
+        stats.victim_evictions++;
+        spill_entry(victim_way);
+    }
+    
+    stats.prefetch_insertions++;
+    shadow_touch(address);
+    energy.data_pj += energy_model.write_energy();
+    entries[victim_way].address = address;
+    entries[victim_way].tag = address / BLOCK_SIZE;
+    set_valid(victim_way, true);
+    entries[victim_way].insertion_time = global_lru_counter;
+    entries[victim_way].access_count = 0;
+    entries[victim_way].reuse_distance = 0;
+    entries[victim_way].high_reuse_block = false;
+    set_prefetched(victim_way, true);
+    set_dirty(victim_way, false);
+    update_lru(victim_way);
+    VC_CHECK_CONSISTENCY();
 }
 
 bool VictimCache::evict_lru(uint64_t& evicted_address, uint8_t* evicted_data) {
@@ -175,8 +489,10 @@ bool VictimCache::evict_lru(uint64_t& evicted_address, uint8_t* evicted_data) {
         memcpy(evicted_data, entries[lru_way].data, BLOCK_SIZE);
     }
     
+    spill_entry(lru_way);
     invalidate_entry(lru_way);
     stats.victim_evictions++;
+    VC_CHECK_CONSISTENCY();
     
     return true;
 }
@@ -184,29 +500,67 @@ bool VictimCache::evict_lru(uint64_t& evicted_address, uint8_t* evicted_data) {
 void VictimCache::promote_to_l2(uint32_t way) {
     if (way < current_size && entries[way].valid) {
         stats.l2_promotions++;
+        spill_entry(way);
         invalidate_entry(way);
+        VC_CHECK_CONSISTENCY();
     }
 }
 
 void VictimCache::resize(uint32_t new_size) {
-    if (new_size < MIN_VICTIM_SIZE || new_size > MAX_VICTIM_SIZE) {
+    if (new_size < MIN_VICTIM_SIZE || new_size > max_size) {
         std::cerr << "[VictimCache] Invalid size: " << new_size << std::endl;
         return;
     }
     
     if (new_size < current_size) {
+        flushed_ghosts.clear();
         for (uint32_t i = new_size; i < current_size; i++) {
             if (entries[i].valid) {
+                flushed_ghosts.insert(entries[i].address);
+                stats.resize_flushes++;
+                spill_entry(i);
                 invalidate_entry(i);
                 stats.victim_evictions++;
             }
         }
     }
     
-    std::cout << "[VictimCache] Resized from " << current_size 
-              << " to " << new_size << " entries" << std::endl;
+    if (power_gating && new_size < current_size) {
+        energy.gate_events++;
+        energy.entries_gated += current_size - new_size;
+    } else if (power_gating && new_size > current_size) {
+        energy.entries_woken += new_size - current_size;
+        energy.wakeup_pj += energy_model.wakeup_energy(new_size - current_size);
+    }
+    
+    if (verbose) {
+        std::cout << "[VictimCache] Resized from " << current_size 
+                  << " to " << new_size << " entries" << std::endl;
+    }
     current_size = new_size;
+    stats.occupancy_rate = (double)valid_entries / current_size;
+    VC_CHECK_CONSISTENCY();
 }
+void VictimCache::close_metrics_interval() {
+    metrics.lookups.close(stats.total_accesses);
+    metrics.hits.close(stats.victim_hits);
+    metrics.insertions.close(stats.victim_insertions);
+    
+    // An idle interval says nothing about the cache; leave the averages alone
+    if (metrics.lookups.get() > 0) {
+        metrics.interval_hit_rate = (double)metrics.hits.get() / metrics.lookups.get();
+        metrics.hit_rate_ewma.add(metrics.interval_hit_rate);
+    } else {
+        metrics.interval_hit_rate = 0.0;
+    }
+    if (metrics.insertions.get() > 0) {
+        metrics.interval_reuse = (double)metrics.hits.get() / metrics.insertions.get();
+        metrics.reuse_ewma.add(metrics.interval_reuse);
+    } else {
+        metrics.interval_reuse = 0.0;
+    }
+}
+
 void VictimStats::update_rates(uint32_t /* current_size */) {
     if (total_accesses > 0) {
         hit_rate = (double)victim_hits / total_accesses;
@@ -230,25 +584,47 @@ void VictimStats::record_phase() {
 
 void VictimCache::update_phase_stats(uint64_t instruction_count) {
     if (instruction_count % PHASE_WINDOW == 0) {
-        stats.occupancy_rate = get_occupancy();
-        stats.update_rates(current_size);
         stats.record_phase();
     }
 }
 
-double VictimCache::get_occupancy() const {
-    uint32_t valid_count = get_valid_entries();
-    return (double)valid_count / current_size;
-}
-
-uint32_t VictimCache::get_valid_entries() const {
-    uint32_t count = 0;
-    for (uint32_t i = 0; i < current_size; i++) {
+bool VictimCache::check_consistency() const {
+    uint32_t valid = 0, dirty = 0, prefetched = 0;
+    bool ok = true;
+    for (uint32_t i = 0; i < max_size; i++) {
         if (entries[i].valid) {
-            count++;
+            valid++;
+            if (i >= current_size) {
+                std::cerr << "[VictimCache] Entry " << i << " valid beyond size "
+                          << current_size << std::endl;
+                ok = false;
+            }
         }
+        dirty += entries[i].dirty;
+        prefetched += entries[i].prefetched;
+    }
+    
+    if (valid != valid_entries || dirty != dirty_entries || prefetched != prefetched_entries) {
+        std::cerr << "[VictimCache] Count mismatch: valid " << valid_entries << "/" << valid
+                  << ", dirty " << dirty_entries << "/" << dirty
+                  << ", prefetched " << prefetched_entries << "/" << prefetched
+                  << " (maintained/scanned)" << std::endl;
+        ok = false;
+    }
+    
+    double hit_rate = stats.total_accesses > 0 ?
+                      (double)stats.victim_hits / stats.total_accesses : 0.0;
+    double reuse = stats.victim_insertions > 0 ?
+                   (double)stats.victim_hits / stats.victim_insertions : 0.0;
+    double occupancy = (double)valid / current_size;
+    if (hit_rate != stats.hit_rate || reuse != stats.reuse_frequency ||
+        occupancy != stats.occupancy_rate) {
+        std::cerr << "[VictimCache] Stale rates: hit " << stats.hit_rate << "/" << hit_rate
+                  << ", reuse " << stats.reuse_frequency << "/" << reuse
+                  << ", occupancy " << stats.occupancy_rate << "/" << occupancy << std::endl;
+        ok = false;
     }
-    return count;
+    return ok;
 }
 
 void VictimCache::print_stats() const {
@@ -258,6 +634,10 @@ void VictimCache::print_stats() const {
     std::cout << "  Valid Entries: " << get_valid_entries() << std::endl;
     std::cout << "  Occupancy: " << std::fixed << std::setprecision(2) 
               << (get_occupancy() * 100) << "%" << std::endl;
+    std::cout << "  Dirty Entries: " << dirty_entries << std::endl;
+    if (prefetched_entries > 0) {
+        std::cout << "  Prefetched Entries: " << prefetched_entries << std::endl;
+    }
     
     std::cout << "\nAccess Statistics:" << std::endl;
     std::cout << "  Total Accesses: " << stats.total_accesses << std::endl;
@@ -269,21 +649,70 @@ void VictimCache::print_stats() const {
     std::cout << "  Insertions: " << stats.victim_insertions << std::endl;
     std::cout << "  Bypassed: " << stats.bypassed_insertions << std::endl;
     std::cout << "  Predicted Reuses: " << stats.predicted_reuses << std::endl;
+    if (stats.prefetch_insertions > 0) {
+        std::cout << "  Prefetch Insertions: " << stats.prefetch_insertions << std::endl;
+        std::cout << "  Prefetch Hits: " << stats.prefetch_hits << std::endl;
+    }
     if (stats.victim_insertions + stats.bypassed_insertions > 0) {
         double bypass_rate = (double)stats.bypassed_insertions / 
                             (stats.victim_insertions + stats.bypassed_insertions);
         std::cout << "  Bypass Rate: " << (bypass_rate * 100) << "%" << std::endl;
     }
+    if (bypass_dueling) {
+        print_duel_stats();
+    }
     
     std::cout << "\nOperations:" << std::endl;
     std::cout << "  Evictions: " << stats.victim_evictions << std::endl;
     std::cout << "  L2 Promotions: " << stats.l2_promotions << std::endl;
+    std::cout << "  Dirty Insertions: " << stats.dirty_insertions << std::endl;
+    std::cout << "  Write-backs: " << stats.writebacks << std::endl;
+    if (stats.swaps > 0 || stats.invalidations > 0) {
+        std::cout << "  Swaps: " << stats.swaps << std::endl;
+        std::cout << "  Invalidations: " << stats.invalidations << std::endl;
+    }
+    if (stats.resize_flushes > 0) {
+        std::cout << "  Resize Flushes: " << stats.resize_flushes
+                  << " (" << stats.churn_misses << " later missed)" << std::endl;
+    }
     std::cout << "  Reuse Frequency: " << stats.reuse_frequency << std::endl;
     
     std::cout << "================================\n" << std::endl;
 }
 
+void VictimCache::print_duel_stats() const {
+    const BoundedHistory<uint16_t>& history = stats.psel_history;
+    std::cout << "  Bypass Dueling: PSEL " << psel << "/" << DUEL_PSEL_MAX << ", followers "
+              << (get_follower_policy() == BYPASS_LENIENT ? "lenient" : "configured")
+              << ", " << stats.duel_switches << " switches" << std::endl;
+    if (history.empty()) {
+        return;
+    }
+    
+    // One character per sample, C configured or L lenient; long runs show the tail
+    uint64_t lenient = 0;
+    std::string timeline;
+    for (size_t i = 0; i < history.size(); i++) {
+        bool lenient_won = history[i] > DUEL_PSEL_MAX / 2;
+        lenient += lenient_won;
+        if (i + DUEL_TIMELINE_LENGTH >= history.size()) {
+            timeline += lenient_won ? 'L' : 'C';
+        }
+    }
+    std::cout << "  Lenient Won: " << (100.0 * lenient / history.size()) << "% of ";
+    if (history.total() > history.size()) {
+        std::cout << "the last " << history.size() << " of " << history.total() << " samples" << std::endl;
+    } else {
+        std::cout << history.size() << " samples" << std::endl;
+    }
+    std::cout << "  Winner Timeline: " << timeline << std::endl;
+}
+
 void VictimCache::reset_stats() {
     stats = VictimStats();
+    stats.occupancy_rate = (double)valid_entries / current_size;
+    energy = EnergyStats();
+    metrics = VictimMetrics();
+    std::fill(stack_distance_hits.begin(), stack_distance_hits.end(), 0);
 }
 
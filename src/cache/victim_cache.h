@@ -4,15 +4,37 @@
 #include <cstdint>
 #include <vector>
 #include <string>
+#include <unordered_set>
+#include "energy_model.h"
+#include "../monitoring/metrics.h"
+#include "../config/sim_config.h"
 
 #define DEFAULT_VICTIM_SIZE 128
-#define MIN_VICTIM_SIZE 64
-#define MAX_VICTIM_SIZE 256
 #define BLOCK_SIZE 64
 #define PHASE_WINDOW 10000
 
-#define REUSE_PREDICTION_THRESHOLD 2
-#define BYPASS_STREAMING_THRESHOLD 10
+// Set dueling (DIP, Qureshi et al.) between the configured bypass thresholds
+// and a lenient pair that admits every non-streaming block. Blocks hash into
+// 2^DUEL_CONSTITUENCY_BITS groups; one group in DUEL_LEADER_STRIDE is a leader
+// for each policy, and leader misses move PSEL, which picks the policy used
+// for all other (follower) blocks.
+#define DUEL_CONSTITUENCY_BITS 10
+#define DUEL_LEADER_STRIDE 32
+#define DUEL_PSEL_MAX 1023
+#define DUEL_ALT_REUSE_THRESHOLD 0
+#define DUEL_ALT_STREAMING_THRESHOLD (2 * BYPASS_STREAMING_THRESHOLD)
+#define DUEL_SAMPLE_INTERVAL 10000
+#define DUEL_TIMELINE_LENGTH 64
+
+// Stack distances are binned at this granularity; each bin is one candidate size
+#define MRC_BUCKET_SIZE 16
+#define MRC_NUM_BUCKETS (MAX_VICTIM_SIZE / MRC_BUCKET_SIZE)
+
+enum BypassPolicy {
+    BYPASS_CONFIGURED,
+    BYPASS_LENIENT
+};
+
 struct VictimBlock {
     uint64_t address;
     uint64_t tag;
@@ -23,10 +45,21 @@ struct VictimBlock {
     uint32_t access_count;
     uint32_t reuse_distance;  // Track reuse patterns
     bool high_reuse_block;    // Predicted high reuse
+    bool prefetched;          // Filled by a prefetcher, not yet demanded
+    bool dirty;               // Modified since it left L2, needs a write-back
     
     VictimBlock() : address(0), tag(0), valid(false), lru_counter(0), 
                     insertion_time(0), access_count(0), reuse_distance(0),
-                    high_reuse_block(false) {}
+                    high_reuse_block(false), prefetched(false), dirty(false) {}
+};
+
+// A block leaving the victim cache for the next level. Only dirty blocks are
+// spilled unless clean spills are enabled (exclusive hierarchies).
+struct VictimSpill {
+    uint64_t address;
+    bool dirty;
+    
+    VictimSpill(uint64_t addr = 0, bool is_dirty = false) : address(addr), dirty(is_dirty) {}
 };
 
 struct VictimStats {
@@ -38,19 +71,35 @@ struct VictimStats {
     uint64_t total_accesses;
     uint64_t bypassed_insertions;
     uint64_t predicted_reuses;
+    uint64_t prefetch_insertions;
+    uint64_t prefetch_hits;
+    uint64_t dirty_insertions;
+    uint64_t writebacks;
+    uint64_t swaps;
+    uint64_t invalidations;
+    uint64_t resize_flushes;
+    uint64_t churn_misses;
+    uint64_t duel_switches;
     
     double occupancy_rate;
     double hit_rate;
     double reuse_frequency;
     double avg_access_count;
     
-    std::vector<double> miss_ratio_trend;
-    std::vector<double> hit_rate_history;
-    std::vector<double> occupancy_history;
+    // Sampled every PHASE_WINDOW instructions; only the recent tail is kept
+    BoundedHistory<double> miss_ratio_trend;
+    BoundedHistory<double> hit_rate_history;
+    BoundedHistory<double> occupancy_history;
+    // PSEL every DUEL_SAMPLE_INTERVAL lookups, recent tail only; above the
+    // midpoint the followers ran the lenient policy
+    BoundedHistory<uint16_t> psel_history;
     
     VictimStats() : victim_hits(0), victim_misses(0), victim_insertions(0),
                     victim_evictions(0), l2_promotions(0), total_accesses(0),
                     bypassed_insertions(0), predicted_reuses(0),
+                    prefetch_insertions(0), prefetch_hits(0), dirty_insertions(0),
+                    writebacks(0), swaps(0), invalidations(0), resize_flushes(0), churn_misses(0),
+                    duel_switches(0),
                     occupancy_rate(0.0), hit_rate(0.0), reuse_frequency(0.0),
                     avg_access_count(0.0) {}
     
@@ -58,6 +107,23 @@ struct VictimStats {
     void record_phase();
 };
 
+// VictimStats rates are lifetime totals and barely move late in a long run;
+// these track recent behaviour instead. The window covers the last
+// METRICS_WINDOW_EVENTS lookups; interval values cover the span between two
+// close_metrics_interval() calls and feed the EWMAs.
+struct VictimMetrics {
+    SlidingWindowRate hit_window;
+    IntervalCounter lookups;
+    IntervalCounter hits;
+    IntervalCounter insertions;
+    Ewma hit_rate_ewma;
+    Ewma reuse_ewma;
+    double interval_hit_rate;
+    double interval_reuse;
+    
+    VictimMetrics() : interval_hit_rate(0.0), interval_reuse(0.0) {}
+};
+
 class VictimCache {
 private:
     std::vector<VictimBlock> entries;
@@ -71,38 +137,154 @@ private:
     uint64_t last_sequential_addr;
     uint32_t sequential_count;
     
+    std::vector<VictimSpill> pending_spills;
+    bool spill_clean_blocks;
+    
+    // Bypass settings; start at the compile-time defaults and can be
+    // retuned at run time by the adaptive controller
+    uint32_t reuse_threshold;
+    uint32_t streaming_threshold;
+    
+    bool bypass_dueling;
+    uint32_t psel;
+    
+    // LRU stack of MAX_VICTIM_SIZE blocks (MRU first) fed with the same
+    // inserts and hits as the real entries. A lookup found at depth d would
+    // hit in any victim cache larger than d, so one pass yields the hit
+    // counts of every size (Mattson et al.). Kept only while a policy that
+    // reads the counts is active; otherwise it is empty and never touched.
+    bool track_stack_distance;
+    std::vector<uint64_t> shadow_stack;
+    std::vector<uint64_t> stack_distance_hits;
+    
+    // Blocks flushed by the last shrink; a lookup missing on one of them is a
+    // miss the resize caused (churn)
+    std::unordered_set<uint64_t> flushed_ghosts;
+    
+    // With power gating, entries beyond current_size are switched off and
+    // stop leaking; without it a shrink only stops them being used
+    EnergyModel energy_model;
+    EnergyStats energy;
+    bool power_gating;
+    
+    // Logs resizes and prints the final statistics on destruction
+    bool verbose;
+    
+    VictimMetrics metrics;
+    
+    // Entries with each flag set, kept in step with every flag change so the
+    // occupancy queries never scan
+    uint32_t valid_entries;
+    uint32_t dirty_entries;
+    uint32_t prefetched_entries;
+    
+    void set_valid(uint32_t way, bool valid);
+    void set_dirty(uint32_t way, bool dirty);
+    void set_prefetched(uint32_t way, bool prefetched);
+    
     uint32_t find_lru_way();
     void update_lru(uint32_t way);
     
-    int32_t find_victim_entry(uint64_t address);
+    int32_t find_victim_entry(uint64_t address) const;
     void invalidate_entry(uint32_t way);
+    void spill_entry(uint32_t way);
     
     bool should_insert(uint64_t address, uint32_t l2_access_count);
-    bool is_streaming_access(uint64_t address);
+    bool is_streaming_access(uint64_t address, uint32_t threshold);
+    int32_t duel_leader(uint64_t address) const;
+    BypassPolicy bypass_policy_for(uint64_t address) const;
+    void train_psel(uint64_t address);
     void update_access_history(uint64_t address);
     uint32_t predict_reuse_potential(uint64_t address);
+    
+    int32_t shadow_depth(uint64_t address) const;
+    void shadow_touch(uint64_t address);
+    void shadow_promote(int32_t depth, uint64_t address);
+    void shadow_remove(uint64_t address);
+    bool take_ghost(uint64_t address);
 
 public:
-    VictimCache(uint32_t size = DEFAULT_VICTIM_SIZE);
+    VictimCache(uint32_t size = DEFAULT_VICTIM_SIZE, const SimConfig& config = SimConfig());
     ~VictimCache();
     
-    bool lookup(uint64_t address);
+    bool lookup(uint64_t address, bool* was_prefetched = nullptr, bool* was_dirty = nullptr);
+    bool contains(uint64_t address) const { return find_victim_entry(address) >= 0; }
     void insert(uint64_t address, uint64_t tag, uint8_t* data);
-    void insert_smart(uint64_t address, uint64_t tag, uint8_t* data, uint32_t access_count);
+    bool insert_smart(uint64_t address, uint64_t tag, uint8_t* data, uint32_t access_count,
+                      bool dirty = false);
+    void insert_prefetch(uint64_t address);
+    
+    // Jouppi-style swap: the block hit in the victim cache moves up and the
+    // incoming L1 victim takes over its entry
+    void swap(uint64_t hit_address, uint64_t incoming_address, bool incoming_dirty,
+              uint32_t incoming_access_count);
+    bool invalidate(uint64_t address, bool* was_dirty = nullptr);
+    
+    // Blocks leaving the victim cache (evicted, bypassed, or flushed by a
+    // resize) queue here until the next level drains them
+    void take_spills(std::vector<VictimSpill>& out);
+    bool has_pending_spills() const { return !pending_spills.empty(); }
+    void set_spill_clean_blocks(bool enable) { spill_clean_blocks = enable; }
+    void get_resident_addresses(std::vector<uint64_t>& out) const;
+    
+    void set_reuse_threshold(uint32_t threshold) { reuse_threshold = threshold; }
+    void set_streaming_threshold(uint32_t threshold) { streaming_threshold = threshold; }
+    uint32_t get_reuse_threshold() const { return reuse_threshold; }
+    uint32_t get_streaming_threshold() const { return streaming_threshold; }
+    
+    // Let leader groups duel the configured thresholds against the lenient ones
+    void set_bypass_dueling(bool enable) { bypass_dueling = enable; }
+    bool is_bypass_dueling() const { return bypass_dueling; }
+    uint32_t get_psel() const { return psel; }
+    BypassPolicy get_follower_policy() const {
+        return psel > DUEL_PSEL_MAX / 2 ? BYPASS_LENIENT : BYPASS_CONFIGURED;
+    }
+    
     bool evict_lru(uint64_t& evicted_address, uint8_t* evicted_data);
     void promote_to_l2(uint32_t way);
     
+    // Up to MAX_VICTIM_SIZE, or the construction size if that was larger
     void resize(uint32_t new_size);
     uint32_t get_current_size() const { return current_size; }
+    uint32_t get_max_size() const { return max_size; }
+    void set_verbose(bool enable) { verbose = enable; }
+    
+    // Cumulative lookups that hit at stack depth [b * MRC_BUCKET_SIZE,
+    // (b + 1) * MRC_BUCKET_SIZE); hits(size) is the sum of the bins below size
+    const std::vector<uint64_t>& get_stack_distance_hits() const { return stack_distance_hits; }
+    // Turning tracking off drops the shadow stack; turned back on, it warms up again
+    void set_stack_distance_tracking(bool enable);
+    bool is_tracking_stack_distance() const { return track_stack_distance; }
+    
+    // Charges leakage for `cycles` of simulated time on the powered entries
+    void advance_cycles(uint64_t cycles) {
+        energy.cycles += cycles;
+        energy.leakage_pj += energy_model.leakage_energy(get_powered_entries(), cycles);
+    }
+    void set_power_gating(bool enable) { power_gating = enable; }
+    bool is_power_gating() const { return power_gating; }
+    uint32_t get_powered_entries() const { return power_gating ? current_size : max_size; }
+    const EnergyStats& get_energy_stats() const { return energy; }
+    const EnergyModel& get_energy_model() const { return energy_model; }
+    
+    void close_metrics_interval();
+    const VictimMetrics& get_metrics() const { return metrics; }
     
     const VictimStats& get_stats() const { return stats; }
     VictimStats& get_stats() { return stats; }
     void print_stats() const;
+    void print_duel_stats() const;
     void reset_stats();
     void update_phase_stats(uint64_t instruction_count);
     
-    double get_occupancy() const;
-    uint32_t get_valid_entries() const;
+    double get_occupancy() const { return (double)valid_entries / current_size; }
+    uint32_t get_valid_entries() const { return valid_entries; }
+    uint32_t get_dirty_entries() const { return dirty_entries; }
+    uint32_t get_prefetched_entries() const { return prefetched_entries; }
+    
+    // Recounts every entry and compares against the maintained counts and
+    // rates; runs after each update in builds with VC_DEBUG_CHECKS
+    bool check_consistency() const;
 };
 
 #endif
@@ -0,0 +1,227 @@
+#include "sim_config.h"
+#include <iostream>
+#include <fstream>
+#include <stdexcept>
+#include <limits>
+
+SimConfig::SimConfig()
+    : static_victim_size(SIM_STATIC_VICTIM_SIZE), adaptive_start_size(SIM_ADAPTIVE_START_SIZE),
+      reuse_threshold(REUSE_PREDICTION_THRESHOLD), streaming_threshold(BYPASS_STREAMING_THRESHOLD),
+      detection_window(DETECTION_WINDOW), phase_change_threshold(PHASE_CHANGE_THRESHOLD),
+      signature_distance_threshold(SIGNATURE_DISTANCE_THRESHOLD),
+      mem_intensity_threshold(HIGH_MEM_INTENSITY), high_miss_rate(HIGH_MISS_RATE),
+      adaptation_interval(ADAPTATION_INTERVAL), size_step(SIZE_ADJUSTMENT_STEP),
+      hit_rate_high(HIT_RATE_THRESHOLD_HIGH), hit_rate_low(HIT_RATE_THRESHOLD_LOW),
+      occupancy_high(OCCUPANCY_THRESHOLD_HIGH), occupancy_low(OCCUPANCY_THRESHOLD_LOW),
+      check_interval(SIM_ADAPTATION_CHECK_INTERVAL) {
+}
+
+static std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+// stoull and stod skip trailing text ("12abc") and stoull wraps a leading
+// '-' around, so both are checked here
+static bool parse_unsigned(const std::string& text, uint64_t max_value, uint64_t& value) {
+    if (text.empty() || text[0] == '-') {
+        return false;
+    }
+    try {
+        size_t pos = 0;
+        unsigned long long parsed = std::stoull(text, &pos);
+        if (pos != text.size() || parsed > max_value) {
+            return false;
+        }
+        value = parsed;
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+bool parse_number(const std::string& text, uint32_t& value) {
+    uint64_t parsed;
+    if (!parse_unsigned(text, std::numeric_limits<uint32_t>::max(), parsed)) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+bool parse_number(const std::string& text, uint64_t& value) {
+    return parse_unsigned(text, std::numeric_limits<uint64_t>::max(), value);
+}
+
+bool parse_number(const std::string& text, double& value) {
+    try {
+        size_t pos = 0;
+        double parsed = std::stod(text, &pos);
+        if (pos != text.size()) {
+            return false;
+        }
+        value = parsed;
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+bool SimConfig::load_file(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "[SimConfig] Cannot open " << path << std::endl;
+        return false;
+    }
+    
+    std::string line;
+    uint32_t line_number = 0;
+    while (std::getline(in, line)) {
+        line_number++;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) {
+            continue;
+        }
+        
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            std::cerr << "[SimConfig] " << path << ":" << line_number
+                      << ": expected key = value" << std::endl;
+            return false;
+        }
+        if (!set(trim(line.substr(0, equals)), trim(line.substr(equals + 1)))) {
+            std::cerr << "[SimConfig] " << path << ":" << line_number << ": rejected" << std::endl;
+            return false;
+        }
+    }
+    return validate();
+}
+
+bool SimConfig::apply_override(const std::string& assignment) {
+    size_t equals = assignment.find('=');
+    if (equals == std::string::npos) {
+        std::cerr << "[SimConfig] Expected key=value, got " << assignment << std::endl;
+        return false;
+    }
+    return set(trim(assignment.substr(0, equals)), trim(assignment.substr(equals + 1))) && validate();
+}
+
+bool SimConfig::set(const std::string& key, const std::string& value) {
+    bool parsed;
+    if (key == "victim.static_size") {
+        parsed = parse_number(value, static_victim_size);
+    } else if (key == "victim.adaptive_start_size") {
+        parsed = parse_number(value, adaptive_start_size);
+    } else if (key == "victim.reuse_threshold") {
+        parsed = parse_number(value, reuse_threshold);
+    } else if (key == "victim.streaming_threshold") {
+        parsed = parse_number(value, streaming_threshold);
+    } else if (key == "phase.window") {
+        parsed = parse_number(value, detection_window);
+    } else if (key == "phase.change_threshold") {
+        parsed = parse_number(value, phase_change_threshold);
+    } else if (key == "phase.signature_threshold") {
+        parsed = parse_number(value, signature_distance_threshold);
+    } else if (key == "phase.mem_intensity") {
+        parsed = parse_number(value, mem_intensity_threshold);
+    } else if (key == "phase.high_miss_rate") {
+        parsed = parse_number(value, high_miss_rate);
+    } else if (key == "adaptive.interval") {
+        parsed = parse_number(value, adaptation_interval);
+    } else if (key == "adaptive.size_step") {
+        parsed = parse_number(value, size_step);
+    } else if (key == "adaptive.hit_rate_high") {
+        parsed = parse_number(value, hit_rate_high);
+    } else if (key == "adaptive.hit_rate_low") {
+        parsed = parse_number(value, hit_rate_low);
+    } else if (key == "adaptive.occupancy_high") {
+        parsed = parse_number(value, occupancy_high);
+    } else if (key == "adaptive.occupancy_low") {
+        parsed = parse_number(value, occupancy_low);
+    } else if (key == "sim.check_interval") {
+        parsed = parse_number(value, check_interval);
+    } else {
+        std::cerr << "[SimConfig] Unknown key: " << key << std::endl;
+        return false;
+    }
+    if (!parsed) {
+        std::cerr << "[SimConfig] Invalid value for " << key << ": " << value << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Written so that a NaN parsed from "nan" is out of range too
+static bool is_fraction(double value) {
+    return value >= 0.0 && value <= 1.0;
+}
+
+bool SimConfig::validate(bool report) const {
+    bool ok = true;
+    if (static_victim_size < MIN_VICTIM_SIZE || static_victim_size > MAX_VICTIM_SIZE ||
+        adaptive_start_size < MIN_VICTIM_SIZE || adaptive_start_size > MAX_VICTIM_SIZE) {
+        if (report) {
+            std::cerr << "[SimConfig] Victim sizes must be within " << MIN_VICTIM_SIZE << "-"
+                      << MAX_VICTIM_SIZE << std::endl;
+        }
+        ok = false;
+    }
+    if (detection_window == 0 || adaptation_interval == 0 || check_interval == 0 || size_step == 0) {
+        if (report) {
+            std::cerr << "[SimConfig] Windows, intervals and the size step must be positive" << std::endl;
+        }
+        ok = false;
+    }
+    if (!is_fraction(hit_rate_high) || !is_fraction(hit_rate_low) ||
+        !is_fraction(occupancy_high) || !is_fraction(occupancy_low) || !is_fraction(high_miss_rate) ||
+        !is_fraction(phase_change_threshold) || !is_fraction(signature_distance_threshold)) {
+        if (report) {
+            std::cerr << "[SimConfig] Rate, occupancy and phase thresholds must be within 0-1" << std::endl;
+        }
+        ok = false;
+    }
+    if (!(mem_intensity_threshold >= 0.0)) {
+        if (report) {
+            std::cerr << "[SimConfig] The memory intensity threshold must not be negative" << std::endl;
+        }
+        ok = false;
+    }
+    if (reuse_threshold > SIM_MAX_REUSE_THRESHOLD || streaming_threshold == 0 ||
+        streaming_threshold > SIM_MAX_STREAMING_THRESHOLD) {
+        if (report) {
+            std::cerr << "[SimConfig] The reuse threshold must be within 0-" << SIM_MAX_REUSE_THRESHOLD
+                      << " and the streaming threshold within 1-" << SIM_MAX_STREAMING_THRESHOLD << std::endl;
+        }
+        ok = false;
+    }
+    if (hit_rate_low > hit_rate_high || occupancy_low > occupancy_high) {
+        if (report) {
+            std::cerr << "[SimConfig] A low threshold is above its high threshold" << std::endl;
+        }
+        ok = false;
+    }
+    return ok;
+}
+
+void SimConfig::write(std::ostream& out) const {
+    out << "victim.static_size = " << static_victim_size << "\n";
+    out << "victim.adaptive_start_size = " << adaptive_start_size << "\n";
+    out << "victim.reuse_threshold = " << reuse_threshold << "\n";
+    out << "victim.streaming_threshold = " << streaming_threshold << "\n";
+    out << "phase.window = " << detection_window << "\n";
+    out << "phase.change_threshold = " << phase_change_threshold << "\n";
+    out << "phase.signature_threshold = " << signature_distance_threshold << "\n";
+    out << "phase.mem_intensity = " << mem_intensity_threshold << "\n";
+    out << "phase.high_miss_rate = " << high_miss_rate << "\n";
+    out << "adaptive.interval = " << adaptation_interval << "\n";
+    out << "adaptive.size_step = " << size_step << "\n";
+    out << "adaptive.hit_rate_high = " << hit_rate_high << "\n";
+    out << "adaptive.hit_rate_low = " << hit_rate_low << "\n";
+    out << "adaptive.occupancy_high = " << occupancy_high << "\n";
+    out << "adaptive.occupancy_low = " << occupancy_low << "\n";
+    out << "sim.check_interval = " << check_interval << "\n";
+}
@@ -0,0 +1,93 @@
+#ifndef SIM_CONFIG_H
+#define SIM_CONFIG_H
+
+#include <cstdint>
+#include <string>
+#include <ostream>
+
+// Defaults of the run-time tunables below. They live here rather than in the
+// modules' headers so the config layer does not depend on its consumers.
+
+// Victim cache
+#define MIN_VICTIM_SIZE 64
+#define MAX_VICTIM_SIZE 256
+#define REUSE_PREDICTION_THRESHOLD 2
+#define BYPASS_STREAMING_THRESHOLD 10
+
+// Phase detector. A window above HIGH_MEM_INTENSITY accesses per 1K
+// instructions with a miss rate above HIGH_MISS_RATE is memory intensive;
+// below half of it, compute bound
+#define DETECTION_WINDOW 50000
+#define PHASE_CHANGE_THRESHOLD 0.15
+#define SIGNATURE_DISTANCE_THRESHOLD 0.5
+#define HIGH_MEM_INTENSITY 100.0
+#define HIGH_MISS_RATE 0.10
+
+// Adaptive controller
+#define ADAPTATION_INTERVAL 50000
+#define SIZE_ADJUSTMENT_STEP 32
+#define HIT_RATE_THRESHOLD_HIGH 0.08
+#define HIT_RATE_THRESHOLD_LOW 0.02
+#define OCCUPANCY_THRESHOLD_HIGH 0.75
+#define OCCUPANCY_THRESHOLD_LOW 0.30
+
+// Check the adaptive controller every this many simulated instructions
+#define SIM_ADAPTATION_CHECK_INTERVAL 5000
+#define SIM_STATIC_VICTIM_SIZE 128
+#define SIM_ADAPTIVE_START_SIZE 80
+// Bypass thresholds count accesses; past these the filters admit or bypass
+// nearly everything, which is what the plain victim cache already does
+#define SIM_MAX_REUSE_THRESHOLD 64
+#define SIM_MAX_STREAMING_THRESHOLD 1024
+
+// Whole-string number parsing for config values and command-line flags.
+// False, leaving `value` alone, on empty or trailing text, a leading '-'
+// for the unsigned forms, or a value that does not fit.
+bool parse_number(const std::string& text, uint32_t& value);
+bool parse_number(const std::string& text, uint64_t& value);
+bool parse_number(const std::string& text, double& value);
+
+// Run-time tunables of the victim cache, phase detector, adaptive controller
+// and simulator. Defaults are the compile-time values in each module's
+// header; a key=value file and --set overrides change them without a
+// rebuild. Components copy what they need when constructed, so nothing here
+// is read on the access path.
+struct SimConfig {
+    // victim.*
+    uint32_t static_victim_size;
+    uint32_t adaptive_start_size;
+    uint32_t reuse_threshold;
+    uint32_t streaming_threshold;
+    
+    // phase.*
+    uint64_t detection_window;
+    double phase_change_threshold;
+    double signature_distance_threshold;
+    double mem_intensity_threshold;
+    double high_miss_rate;
+    
+    // adaptive.*
+    uint64_t adaptation_interval;
+    uint32_t size_step;
+    double hit_rate_high;
+    double hit_rate_low;
+    double occupancy_high;
+    double occupancy_low;
+    
+    // sim.*
+    uint64_t check_interval;
+    
+    SimConfig();
+    
+    // Lines are `key = value`; blank lines and text after '#' are ignored
+    bool load_file(const std::string& path);
+    // Accepts "key=value" as given on the command line
+    bool apply_override(const std::string& assignment);
+    bool set(const std::string& key, const std::string& value);
+    bool validate(bool report = true) const;
+    
+    // Writes every key in the format load_file() reads
+    void write(std::ostream& out) const;
+};
+
+#endif
@@ -1,11 +1,14 @@
 #include "cache/victim_cache.h"
 #include "monitoring/phase_detector.h"
 #include "adaptive/adaptive_controller.h"
+#include "monitoring/profiler.h"
 #include "../benchmarks/synthetic_benchmark.h"
 #include <iostream>
 #include <string>
 #include <cstring>
 
+static BenchmarkRun run_options;
+
 void print_usage(const char* program_name) {
     std::cout << "Usage: " << program_name << " [options]" << std::endl;
     std::cout << "Options:" << std::endl;
@@ -13,8 +16,16 @@ void print_usage(const char* program_name) {
     std::cout << "  --checkpoint2     Run Checkpoint 2 validation (adaptive victim cache)" << std::endl;
     std::cout << "  --all             Run all benchmarks" << std::endl;
     std::cout << "  --benchmark <name> Run specific benchmark:" << std::endl;
-    std::cout << "                    sequential, random, repeated, strided, mixed, phase" << std::endl;
-    std::cout << "  --size <n>        Set victim cache size (default: 64)" << std::endl;
+    std::cout << "                    sequential, random, repeated, strided, mixed, phase, zipfian, hotcold" << std::endl;
+    std::cout << "  --size <n>        Set victim cache size, " << MIN_VICTIM_SIZE << "-" << MAX_VICTIM_SIZE
+              << " (default: " << DEFAULT_VICTIM_SIZE << ")" << std::endl;
+    std::cout << "  --iterations <n>  Accesses per benchmark (default: " << BENCHMARK_ITERATIONS << ")" << std::endl;
+    std::cout << "  --seed <n>        Seed for the random patterns (default: " << BENCHMARK_SEED << ")" << std::endl;
+    std::cout << "  --mode <m>        static or adaptive (default: per benchmark)" << std::endl;
+    std::cout << "  --cp-delta <x>    Change-point drift tolerance for the phase benchmark (default: "
+              << CHANGE_POINT_DELTA << ")" << std::endl;
+    std::cout << "  --cp-lambda <x>   Change-point alarm threshold for the phase benchmark (default: "
+              << CHANGE_POINT_LAMBDA << ")" << std::endl;
     std::cout << "  --help            Display this help message" << std::endl;
 }
 
@@ -23,12 +34,12 @@ void run_checkpoint1() {
     std::cout << "CHECKPOINT 1: Static Victim Cache" << std::endl;
     std::cout << "========================================\n" << std::endl;
     
-    BenchmarkSuite suite;
+    BenchmarkSuite suite(run_options);
     
-    suite.add_benchmark(new SequentialBenchmark());
-    suite.add_benchmark(new RandomBenchmark());
-    suite.add_benchmark(new RepeatedBenchmark());
-    suite.add_benchmark(new StridedBenchmark());
+    suite.add_benchmark("sequential");
+    suite.add_benchmark("random");
+    suite.add_benchmark("repeated");
+    suite.add_benchmark("strided");
     
     suite.run_all();
     
@@ -45,10 +56,10 @@ void run_checkpoint2() {
     std::cout << "CHECKPOINT 2: Adaptive Victim Cache" << std::endl;
     std::cout << "========================================\n" << std::endl;
     
-    BenchmarkSuite suite;
+    BenchmarkSuite suite(run_options);
     
-    suite.add_benchmark(new MixedBenchmark());
-    suite.add_benchmark(new PhaseBenchmark());
+    suite.add_benchmark("mixed");
+    suite.add_benchmark("phase");
     
     suite.run_all();
     
@@ -61,31 +72,19 @@ void run_checkpoint2() {
     std::cout << "========================================\n" << std::endl;
 }
 
-void run_specific_benchmark(const std::string& name) {
-    SyntheticBenchmark* bench = nullptr;
-    
-    if (name == "sequential") {
-        bench = new SequentialBenchmark();
-    } else if (name == "random") {
-        bench = new RandomBenchmark();
-    } else if (name == "repeated") {
-        bench = new RepeatedBenchmark();
-    } else if (name == "strided") {
-        bench = new StridedBenchmark();
-    } else if (name == "mixed") {
-        bench = new MixedBenchmark();
-    } else if (name == "phase") {
-        bench = new PhaseBenchmark();
-    } else {
+bool run_specific_benchmark(const std::string& name) {
+    if (!is_benchmark(name)) {
         std::cerr << "Unknown benchmark: " << name << std::endl;
-        return;
+        return false;
     }
     
-    bench->run();
-    delete bench;
+    run_benchmark(name, run_options);
+    return true;
 }
 
 int main(int argc, char* argv[]) {
+    VC_PROFILE_REPORT_AT_EXIT();
+    
     std::cout << "========================================" << std::endl;
     std::cout << "Adaptive Victim Cache Simulator" << std::endl;
     std::cout << "CS683 Final Project" << std::endl;
@@ -98,6 +97,38 @@ int main(int argc, char* argv[]) {
     
     std::string arg = argv[1];
     
+    // --benchmark takes the benchmark name before any options
+    int first_option = (arg == "--benchmark") ? 3 : 2;
+    for (int i = first_option; i < argc; i++) {
+        std::string option = argv[i];
+        bool has_value = i + 1 < argc;
+        if (option == "--cp-delta" && has_value &&
+            parse_number(argv[i + 1], run_options.change_delta) && run_options.change_delta >= 0.0) {
+            i++;
+        } else if (option == "--cp-lambda" && has_value &&
+                   parse_number(argv[i + 1], run_options.change_lambda) && run_options.change_lambda > 0.0) {
+            i++;
+        } else if (option == "--size" && has_value && parse_number(argv[i + 1], run_options.victim_size) &&
+                   run_options.victim_size >= MIN_VICTIM_SIZE && run_options.victim_size <= MAX_VICTIM_SIZE) {
+            i++;
+        } else if (option == "--iterations" && has_value &&
+                   parse_number(argv[i + 1], run_options.iterations) && run_options.iterations > 0) {
+            i++;
+        } else if (option == "--seed" && has_value && parse_number(argv[i + 1], run_options.seed)) {
+            i++;
+        } else if (option == "--mode" && has_value && std::string(argv[i + 1]) == "static") {
+            run_options.mode = BENCH_CACHE_STATIC;
+            i++;
+        } else if (option == "--mode" && has_value && std::string(argv[i + 1]) == "adaptive") {
+            run_options.mode = BENCH_CACHE_ADAPTIVE;
+            i++;
+        } else {
+            std::cerr << "Unknown option or invalid value: " << option << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    
     if (arg == "--help") {
         print_usage(argv[0]);
         return 0;
@@ -109,7 +140,9 @@ int main(int argc, char* argv[]) {
         run_checkpoint1();
         run_checkpoint2();
     } else if (arg == "--benchmark" && argc >= 3) {
-        run_specific_benchmark(argv[2]);
+        if (!run_specific_benchmark(argv[2])) {
+            return 1;
+        }
     } else {
         std::cerr << "Unknown option: " << arg << std::endl;
         print_usage(argv[0]);
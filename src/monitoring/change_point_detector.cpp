@@ -0,0 +1,48 @@
+#include "change_point_detector.h"
+#include <algorithm>
+
+ChangePointDetector::ChangePointDetector(double drift, double threshold)
+    : delta(drift), lambda(threshold), alarms(0), last_alarm_sample(0), total_samples(0) {
+    reset();
+}
+
+void ChangePointDetector::reset() {
+    samples = 0;
+    mean = 0.0;
+    cum_increase = 0.0;
+    min_increase = 0.0;
+    cum_decrease = 0.0;
+    max_decrease = 0.0;
+}
+
+void ChangePointDetector::set_sensitivity(double drift, double threshold) {
+    delta = drift;
+    lambda = threshold;
+    reset();
+}
+
+bool ChangePointDetector::add_sample(double value) {
+    total_samples++;
+    samples++;
+    mean += (value - mean) / samples;
+    
+    // m_t drifts down while the stream is stationary and climbs after an
+    // upward shift; n_t mirrors it for downward shifts
+    cum_increase += value - mean - delta;
+    min_increase = std::min(min_increase, cum_increase);
+    cum_decrease += value - mean + delta;
+    max_decrease = std::max(max_decrease, cum_decrease);
+    
+    // The running mean is too noisy to be a reference right after a reset
+    if (samples < CHANGE_POINT_MIN_SAMPLES) {
+        return false;
+    }
+    
+    if (cum_increase - min_increase > lambda || max_decrease - cum_decrease > lambda) {
+        alarms++;
+        last_alarm_sample = total_samples;
+        reset();
+        return true;
+    }
+    return false;
+}
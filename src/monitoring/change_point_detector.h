@@ -0,0 +1,49 @@
+#ifndef CHANGE_POINT_DETECTOR_H
+#define CHANGE_POINT_DETECTOR_H
+
+#include <cstdint>
+
+// Page-Hinkley defaults for a stream of 0/1 miss indicators. DELTA is the
+// shift in mean that is tolerated as noise; LAMBDA is the accumulated
+// deviation that raises an alarm (lower = more sensitive, more false alarms).
+// The stream is the L1 miss flag per access; a sweep past L1 capacity gives
+// bursts of ~50 consecutive misses within one phase, hence LAMBDA well above that.
+#define CHANGE_POINT_DELTA 0.05
+#define CHANGE_POINT_LAMBDA 200.0
+#define CHANGE_POINT_MIN_SAMPLES 500
+
+// Two-sided Page-Hinkley test. Each sample costs O(1); after an alarm the
+// statistics restart so the new regime becomes the reference.
+class ChangePointDetector {
+private:
+    double delta;
+    double lambda;
+    
+    uint64_t samples;
+    double mean;
+    double cum_increase;
+    double min_increase;
+    double cum_decrease;
+    double max_decrease;
+    
+    uint64_t alarms;
+    uint64_t last_alarm_sample;
+    uint64_t total_samples;
+
+public:
+    ChangePointDetector(double drift = CHANGE_POINT_DELTA, double threshold = CHANGE_POINT_LAMBDA);
+    
+    // Returns true when the mean of the stream has shifted
+    bool add_sample(double value);
+    void reset();
+    
+    void set_sensitivity(double drift, double threshold);
+    double get_delta() const { return delta; }
+    double get_lambda() const { return lambda; }
+    
+    double get_mean() const { return mean; }
+    uint64_t get_alarms() const { return alarms; }
+    uint64_t get_last_alarm_sample() const { return last_alarm_sample; }
+};
+
+#endif
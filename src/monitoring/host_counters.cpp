@@ -0,0 +1,217 @@
+#include "host_counters.h"
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+#include <cerrno>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static const char* const EVENT_NAMES[HOST_NUM_EVENTS] = {
+    "cycles",
+    "instructions",
+    "LLC misses",
+    "branch misses",
+    "dTLB misses",
+};
+
+const char* HostCounters::event_name(HostEvent event) {
+    return EVENT_NAMES[event];
+}
+
+bool HostCounterSample::any_counted() const {
+    for (int e = 0; e < HOST_NUM_EVENTS; e++) {
+        if (counted[e]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+double HostCounterSample::get_ipc() const {
+    if (!counted[HOST_CYCLES] || !counted[HOST_INSTRUCTIONS] || values[HOST_CYCLES] == 0) {
+        return -1.0;
+    }
+    return (double)values[HOST_INSTRUCTIONS] / values[HOST_CYCLES];
+}
+
+double HostCounterSample::get_per_kilo_instruction(HostEvent event) const {
+    if (!counted[event] || !counted[HOST_INSTRUCTIONS] || values[HOST_INSTRUCTIONS] == 0) {
+        return -1.0;
+    }
+    return values[event] * 1000.0 / values[HOST_INSTRUCTIONS];
+}
+
+void HostCounterSample::print() const {
+    std::cout << "\n--- Host Counters (simulator process) ---" << std::endl;
+    for (int e = 0; e < HOST_NUM_EVENTS; e++) {
+        std::cout << "  " << std::left << std::setw(15) << EVENT_NAMES[e] << std::right;
+        if (!counted[e]) {
+            std::cout << std::setw(16) << "n/a" << std::endl;
+            continue;
+        }
+        std::cout << std::setw(16) << values[e];
+        if (e != HOST_CYCLES && e != HOST_INSTRUCTIONS && get_per_kilo_instruction((HostEvent)e) >= 0.0) {
+            std::cout << "  (" << std::fixed << std::setprecision(2)
+                      << get_per_kilo_instruction((HostEvent)e) << " per 1K instr)";
+        }
+        std::cout << std::endl;
+    }
+    if (get_ipc() >= 0.0) {
+        std::cout << "  " << std::left << std::setw(15) << "IPC" << std::right
+                  << std::setw(16) << std::fixed << std::setprecision(3) << get_ipc() << std::endl;
+    }
+    if (multiplexed) {
+        std::cout << "  (counters were multiplexed; values are scaled estimates)" << std::endl;
+    }
+}
+
+HostCounters::HostCounters() : available(false) {
+    for (int e = 0; e < HOST_NUM_EVENTS; e++) {
+        fds[e] = -1;
+        ids[e] = 0;
+    }
+}
+
+HostCounters::~HostCounters() {
+    close();
+}
+
+#ifdef __linux__
+
+static int open_event(uint32_t type, uint64_t config, int group_fd) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = (group_fd == -1);  // members follow the leader
+    attr.exclude_kernel = 1;  // user-space counts are allowed at perf_event_paranoid 2
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID |
+                       PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+bool HostCounters::open() {
+    close();
+    
+    // The generic cache-misses event is last-level misses on x86 and ARM
+    const uint32_t types[HOST_NUM_EVENTS] = {
+        PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE
+    };
+    const uint64_t configs[HOST_NUM_EVENTS] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+    };
+    
+    fds[HOST_CYCLES] = open_event(types[HOST_CYCLES], configs[HOST_CYCLES], -1);
+    if (fds[HOST_CYCLES] < 0) {
+        error = std::string("perf_event_open failed: ") + strerror(errno);
+        if (errno == EACCES || errno == EPERM) {
+            error += " (check /proc/sys/kernel/perf_event_paranoid)";
+        } else if (errno == ENOENT || errno == EOPNOTSUPP) {
+            error += " (no hardware PMU, e.g. inside a VM)";
+        }
+        return false;
+    }
+    if (ioctl(fds[HOST_CYCLES], PERF_EVENT_IOC_ID, &ids[HOST_CYCLES]) != 0) {
+        error = "cannot identify the cycle counter";
+        close();
+        return false;
+    }
+    for (int e = HOST_CYCLES + 1; e < HOST_NUM_EVENTS; e++) {
+        fds[e] = open_event(types[e], configs[e], fds[HOST_CYCLES]);
+        if (fds[e] >= 0 && ioctl(fds[e], PERF_EVENT_IOC_ID, &ids[e]) != 0) {
+            ::close(fds[e]);
+            fds[e] = -1;
+        }
+        if (fds[e] < 0) {
+            std::cerr << "[HostCounters] " << EVENT_NAMES[e] << " not available on this host" << std::endl;
+        }
+    }
+    
+    available = true;
+    error.clear();
+    return true;
+}
+
+void HostCounters::close() {
+    for (int e = 0; e < HOST_NUM_EVENTS; e++) {
+        if (fds[e] >= 0) {
+            ::close(fds[e]);
+            fds[e] = -1;
+        }
+    }
+    available = false;
+}
+
+void HostCounters::measure_begin() {
+    if (!available) {
+        return;
+    }
+    ioctl(fds[HOST_CYCLES], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fds[HOST_CYCLES], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+HostCounterSample HostCounters::measure_end() {
+    HostCounterSample sample;
+    if (!available) {
+        return sample;
+    }
+    ioctl(fds[HOST_CYCLES], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    
+    // nr, time_enabled, time_running, then a {value, id} pair per member
+    uint64_t buffer[3 + 2 * HOST_NUM_EVENTS];
+    ssize_t bytes = read(fds[HOST_CYCLES], buffer, sizeof(buffer));
+    if (bytes < (ssize_t)(3 * sizeof(uint64_t))) {
+        std::cerr << "[HostCounters] Cannot read the counter group" << std::endl;
+        return sample;
+    }
+    uint64_t members = buffer[0];
+    uint64_t enabled = buffer[1];
+    uint64_t running = buffer[2];
+    if (running == 0) {
+        // The PMU never had room for the group (other perf users, too many events)
+        return sample;
+    }
+    double scale = (double)enabled / running;
+    sample.multiplexed = running < enabled;
+    for (uint64_t m = 0; m < members && 3 + 2 * m + 1 < sizeof(buffer) / sizeof(buffer[0]); m++) {
+        uint64_t value = buffer[3 + 2 * m];
+        uint64_t id = buffer[3 + 2 * m + 1];
+        for (int e = 0; e < HOST_NUM_EVENTS; e++) {
+            if (fds[e] >= 0 && ids[e] == id) {
+                sample.values[e] = (uint64_t)(value * scale);
+                sample.counted[e] = true;
+            }
+        }
+    }
+    return sample;
+}
+
+#else
+
+bool HostCounters::open() {
+    error = "perf_event_open is only available on Linux";
+    return false;
+}
+
+void HostCounters::close() {
+    available = false;
+}
+
+void HostCounters::measure_begin() {}
+
+HostCounterSample HostCounters::measure_end() {
+    return HostCounterSample();
+}
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef HOST_COUNTERS_H
+#define HOST_COUNTERS_H
+
+#include <cstdint>
+#include <string>
+
+// Hardware counters of the simulator process itself (not the simulated
+// machine), read through Linux perf_event_open. They show whether a change
+// to the engine makes the host run it with fewer misses.
+
+enum HostEvent {
+    HOST_CYCLES,
+    HOST_INSTRUCTIONS,
+    HOST_LLC_MISSES,
+    HOST_BRANCH_MISSES,
+    HOST_DTLB_MISSES,
+    HOST_NUM_EVENTS
+};
+
+struct HostCounterSample {
+    uint64_t values[HOST_NUM_EVENTS];
+    bool counted[HOST_NUM_EVENTS];
+    bool multiplexed;  // values were scaled up from a partial run
+    
+    HostCounterSample() : multiplexed(false) {
+        for (int e = 0; e < HOST_NUM_EVENTS; e++) {
+            values[e] = 0;
+            counted[e] = false;
+        }
+    }
+    
+    bool any_counted() const;
+    double get_ipc() const;
+    // Misses per thousand host instructions, or -1 if either was not counted
+    double get_per_kilo_instruction(HostEvent event) const;
+    void print() const;
+};
+
+// One counter group, opened once and reused for every measured region.
+// Events the kernel or PMU refuses are left out; if even the cycle leader
+// cannot be opened (no PMU in a VM, perf_event_paranoid, non-Linux build)
+// open() returns false and measure_begin()/measure_end() do nothing.
+class HostCounters {
+private:
+    int fds[HOST_NUM_EVENTS];
+    uint64_t ids[HOST_NUM_EVENTS];
+    bool available;
+    std::string error;
+
+public:
+    HostCounters();
+    ~HostCounters();
+    HostCounters(const HostCounters&) = delete;
+    HostCounters& operator=(const HostCounters&) = delete;
+    
+    bool open();
+    void close();
+    bool is_available() const { return available; }
+    const std::string& get_error() const { return error; }
+    
+    void measure_begin();
+    // Counts since measure_begin(); nothing is marked counted if unavailable
+    HostCounterSample measure_end();
+    
+    static const char* event_name(HostEvent event);
+};
+
+#endif
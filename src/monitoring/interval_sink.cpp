@@ -0,0 +1,133 @@
+#include "interval_sink.h"
+#include <iostream>
+
+IntervalMetricsSink::IntervalMetricsSink()
+    : active(0), pending(false), stopping(false), format(SINK_FORMAT_CSV), records(0), stalls(0) {
+}
+
+IntervalMetricsSink::~IntervalMetricsSink() {
+    close();
+}
+
+bool IntervalMetricsSink::open(const std::string& filename, IntervalSinkFormat fmt, size_t buffer_records) {
+    close();
+    
+    std::ios_base::openmode mode = std::ios::out | std::ios::trunc;
+    if (fmt == SINK_FORMAT_BINARY) {
+        mode |= std::ios::binary;
+    }
+    out.open(filename, mode);
+    if (!out.is_open()) {
+        std::cerr << "[IntervalSink] Cannot open " << filename << " for writing" << std::endl;
+        return false;
+    }
+    
+    format = fmt;
+    path = filename;
+    records = 0;
+    stalls = 0;
+    active = 0;
+    pending = false;
+    stopping = false;
+    // append() hands a buffer off when it reaches capacity, so reserve exactly
+    for (std::vector<IntervalRecord>& buffer : buffers) {
+        buffer.clear();
+        buffer.shrink_to_fit();
+        buffer.reserve(buffer_records > 0 ? buffer_records : 1);
+    }
+    
+    if (format == SINK_FORMAT_BINARY) {
+        uint32_t header[3] = {INTERVAL_SINK_MAGIC, INTERVAL_SINK_VERSION, (uint32_t)sizeof(IntervalRecord)};
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    } else {
+        out << "interval,instructions,victim_size,victim_hit_rate,occupancy,"
+               "l1_hit_rate,l2_hit_rate,phase,phase_id,decision\n";
+    }
+    
+    writer = std::thread(&IntervalMetricsSink::writer_loop, this);
+    return true;
+}
+
+void IntervalMetricsSink::hand_off() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (pending) {
+        stalls++;
+        work_done.wait(lock, [this] { return !pending; });
+    }
+    // The writer has finished with the other buffer, so it can be refilled
+    pending = true;
+    active ^= 1;
+    buffers[active].clear();
+    lock.unlock();
+    work_ready.notify_one();
+}
+
+void IntervalMetricsSink::writer_loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        work_ready.wait(lock, [this] { return pending || stopping; });
+        if (pending) {
+            const std::vector<IntervalRecord>& batch = buffers[active ^ 1];
+            lock.unlock();
+            write_records(batch);
+            lock.lock();
+            pending = false;
+            work_done.notify_one();
+        } else {
+            return;
+        }
+    }
+}
+
+void IntervalMetricsSink::write_records(const std::vector<IntervalRecord>& batch) {
+    if (format == SINK_FORMAT_BINARY) {
+        out.write(reinterpret_cast<const char*>(batch.data()), batch.size() * sizeof(IntervalRecord));
+    } else {
+        for (const IntervalRecord& r : batch) {
+            out << r.interval << "," << r.instructions << "," << r.victim_size << ","
+                << r.victim_hit_rate << "," << r.occupancy << ","
+                << r.l1_hit_rate << "," << r.l2_hit_rate << ","
+                << r.phase << "," << r.phase_id << "," << r.decision << "\n";
+        }
+    }
+    records += batch.size();
+}
+
+void IntervalMetricsSink::close() {
+    if (!writer.joinable()) {
+        return;
+    }
+    if (!buffers[active].empty()) {
+        hand_off();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work_ready.notify_one();
+    writer.join();
+    
+    out.close();
+    if (out.fail()) {
+        std::cerr << "[IntervalSink] Error while writing " << path << std::endl;
+    }
+    // Release the buffers; a sink is usually closed well before it is destroyed
+    for (std::vector<IntervalRecord>& buffer : buffers) {
+        std::vector<IntervalRecord>().swap(buffer);
+    }
+}
+
+bool IntervalMetricsSink::parse_format(const std::string& name, IntervalSinkFormat& fmt) {
+    if (name == "csv") {
+        fmt = SINK_FORMAT_CSV;
+    } else if (name == "binary") {
+        fmt = SINK_FORMAT_BINARY;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* IntervalMetricsSink::file_extension(IntervalSinkFormat fmt) {
+    return fmt == SINK_FORMAT_BINARY ? ".bin" : ".csv";
+}
@@ -0,0 +1,98 @@
+#ifndef INTERVAL_SINK_H
+#define INTERVAL_SINK_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#define INTERVAL_SINK_BUFFER_RECORDS 4096
+#define INTERVAL_SINK_MAGIC 0x4d494356  // "VCIM" read as little-endian
+#define INTERVAL_SINK_VERSION 1
+
+enum IntervalSinkFormat {
+    SINK_FORMAT_CSV,
+    SINK_FORMAT_BINARY
+};
+
+// One per interval. Rates cover the interval only, not the run so far. The
+// binary format is a 12-byte header (magic, version, record size, all
+// uint32) followed by these structs exactly as laid out here.
+struct IntervalRecord {
+    uint64_t interval;
+    uint64_t instructions;      // at the end of the interval
+    double victim_hit_rate;
+    double occupancy;
+    double l1_hit_rate;
+    double l2_hit_rate;
+    uint32_t victim_size;
+    int32_t phase;              // WorkloadPhase, -1 without a phase detector
+    int32_t phase_id;           // working-set id, -1 before the first
+    int32_t decision;           // AdaptiveDecision of the interval's last resize, -1 if none
+    
+    IntervalRecord() : interval(0), instructions(0), victim_hit_rate(0.0), occupancy(0.0),
+                       l1_hit_rate(0.0), l2_hit_rate(0.0), victim_size(0), phase(-1),
+                       phase_id(-1), decision(-1) {}
+};
+
+static_assert(sizeof(IntervalRecord) == 64, "IntervalRecord is written to disk as-is");
+
+// Appends records to a file from a background thread. append() fills one
+// buffer while the writer drains the other, so the simulation loop only
+// ever copies 64 bytes; it waits (counted in get_stalls()) only if the
+// writer is still a whole buffer behind. Memory is two buffers, however
+// long the run.
+class IntervalMetricsSink {
+private:
+    std::vector<IntervalRecord> buffers[2];
+    int active;      // buffer append() is filling
+    bool pending;    // the other buffer is waiting for, or being written by, the writer
+    bool stopping;
+    std::ofstream out;
+    IntervalSinkFormat format;
+    std::string path;
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable work_ready;
+    std::condition_variable work_done;
+    uint64_t records;
+    uint64_t stalls;
+    
+    void hand_off();
+    void writer_loop();
+    void write_records(const std::vector<IntervalRecord>& batch);
+
+public:
+    IntervalMetricsSink();
+    ~IntervalMetricsSink();
+    IntervalMetricsSink(const IntervalMetricsSink&) = delete;
+    IntervalMetricsSink& operator=(const IntervalMetricsSink&) = delete;
+    
+    bool open(const std::string& filename, IntervalSinkFormat fmt,
+              size_t buffer_records = INTERVAL_SINK_BUFFER_RECORDS);
+    // A no-op unless open; after close() nothing would drain the buffers
+    void append(const IntervalRecord& record) {
+        if (!writer.joinable()) {
+            return;
+        }
+        buffers[active].push_back(record);
+        if (buffers[active].size() == buffers[active].capacity()) {
+            hand_off();
+        }
+    }
+    // Writes what is buffered, stops the writer and closes the file
+    void close();
+    
+    bool is_open() const { return writer.joinable(); }
+    uint64_t get_records() const { return records; }
+    uint64_t get_stalls() const { return stalls; }
+    const std::string& get_path() const { return path; }
+    
+    static bool parse_format(const std::string& name, IntervalSinkFormat& fmt);
+    static const char* file_extension(IntervalSinkFormat fmt);
+};
+
+#endif
@@ -0,0 +1,13 @@
+#include "metrics.h"
+#include <algorithm>
+
+SlidingWindowRate::SlidingWindowRate(uint32_t capacity)
+    : ring(std::max(capacity, 1u), 0), head(0), filled(0), ones(0) {
+}
+
+void SlidingWindowRate::reset() {
+    std::fill(ring.begin(), ring.end(), 0);
+    head = 0;
+    filled = 0;
+    ones = 0;
+}
@@ -0,0 +1,120 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#define METRICS_WINDOW_EVENTS 4096
+#define METRICS_EWMA_ALPHA 0.3
+#define METRICS_HISTORY_LENGTH 1024
+
+// Exponentially weighted moving average; the first sample seeds it
+class Ewma {
+private:
+    double alpha;
+    double value;
+    bool seeded;
+
+public:
+    Ewma(double smoothing = METRICS_EWMA_ALPHA) : alpha(smoothing), value(0.0), seeded(false) {}
+    
+    void add(double sample) {
+        value = seeded ? alpha * sample + (1.0 - alpha) * value : sample;
+        seeded = true;
+    }
+    double get() const { return value; }
+    bool is_seeded() const { return seeded; }
+    void reset() { value = 0.0; seeded = false; }
+};
+
+// Fraction of the last `capacity` yes/no events that were yes. A ring of
+// flags plus a running count keeps add() and rate() O(1).
+class SlidingWindowRate {
+private:
+    std::vector<uint8_t> ring;
+    uint32_t head;
+    uint32_t filled;
+    uint32_t ones;
+
+public:
+    SlidingWindowRate(uint32_t capacity = METRICS_WINDOW_EVENTS);
+    
+    void add(bool event) {
+        if (filled == ring.size()) {
+            ones -= ring[head];
+        } else {
+            filled++;
+        }
+        ring[head] = event ? 1 : 0;
+        ones += ring[head];
+        head = (head + 1 == ring.size()) ? 0 : head + 1;
+    }
+    double rate() const { return filled > 0 ? (double)ones / filled : 0.0; }
+    uint32_t size() const { return filled; }
+    uint32_t capacity() const { return ring.size(); }
+    void reset();
+};
+
+// Per-interval delta of a counter that only grows
+class IntervalCounter {
+private:
+    uint64_t last_total;
+    uint64_t delta;
+
+public:
+    IntervalCounter() : last_total(0), delta(0) {}
+    
+    void close(uint64_t total) {
+        delta = total - last_total;
+        last_total = total;
+    }
+    uint64_t get() const { return delta; }
+};
+
+// The last `capacity` entries of a per-interval series, oldest first. The
+// ring grows on demand up to capacity and then overwrites, so a long run
+// keeps a fixed footprint; the full series goes to an IntervalMetricsSink.
+template <typename T>
+class BoundedHistory {
+private:
+    std::vector<T> ring;
+    size_t limit;
+    size_t head;  // oldest entry once the ring is full
+    uint64_t recorded;
+
+public:
+    BoundedHistory(size_t capacity = METRICS_HISTORY_LENGTH)
+        : limit(capacity > 0 ? capacity : 1), head(0), recorded(0) {}
+    
+    void push_back(const T& value) {
+        if (ring.size() < limit) {
+            ring.push_back(value);
+        } else {
+            ring[head] = value;
+            head = (head + 1 == limit) ? 0 : head + 1;
+        }
+        recorded++;
+    }
+    const T& operator[](size_t i) const {
+        size_t slot = head + i;
+        return ring[slot >= ring.size() ? slot - ring.size() : slot];
+    }
+    const T& back() const { return (*this)[ring.size() - 1]; }
+    size_t size() const { return ring.size(); }
+    bool empty() const { return ring.empty(); }
+    size_t capacity() const { return limit; }
+    // Entries ever pushed, including overwritten ones
+    uint64_t total() const { return recorded; }
+    
+    std::vector<T> to_vector() const {
+        std::vector<T> out;
+        out.reserve(ring.size());
+        for (size_t i = 0; i < ring.size(); i++) {
+            out.push_back((*this)[i]);
+        }
+        return out;
+    }
+};
+
+#endif
@@ -1,13 +1,21 @@
 #include "phase_detector.h"
+#include "profiler.h"
 #include <iostream>
 #include <iomanip>
 #include <cmath>
 #include <algorithm>
 
-PhaseDetector::PhaseDetector() 
-    : window_start_instruction(0), global_instruction_count(0) {
+PhaseDetector::PhaseDetector(const SimConfig& config)
+    : current_phase(PHASE_UNKNOWN), detection_window(config.detection_window),
+      change_threshold(config.phase_change_threshold),
+      signature_threshold(config.signature_distance_threshold),
+      mem_intensity_threshold(config.mem_intensity_threshold),
+      high_miss_rate(config.high_miss_rate), window_start_instruction(0), global_instruction_count(0),
+      has_previous_signature(false), phase_changes(0),
+      current_phase_id(-1), phase_recurred(false),
+      change_point_pending(false), change_points(0), last_window_phase(PHASE_UNKNOWN) {
     std::cout << "[PhaseDetector] Initialized with window size: " 
-              << DETECTION_WINDOW << std::endl;
+              << detection_window << std::endl;
 }
 
 void PhaseDetector::record_instruction() {
@@ -20,6 +28,30 @@ void PhaseDetector::record_memory_access(bool is_miss) {
     if (is_miss) {
         current_metrics.cache_misses++;
     }
+    
+    if (change_detector.add_sample(is_miss ? 1.0 : 0.0)) {
+        change_point_pending = true;
+        change_points++;
+    }
+}
+
+bool PhaseDetector::check_change_point() {
+    bool pending = change_point_pending;
+    change_point_pending = false;
+    return pending;
+}
+
+void PhaseDetector::set_change_sensitivity(double delta, double lambda) {
+    change_detector.set_sensitivity(delta, lambda);
+}
+
+void PhaseDetector::record_memory_access(uint64_t address, bool is_miss) {
+    VC_PROFILE_SCOPE(PROF_PHASE_RECORD);
+    record_memory_access(is_miss);
+    
+    // Fibonacci hashing spreads neighbouring blocks across the vector
+    uint64_t block = address >> SIGNATURE_BLOCK_SHIFT;
+    current_signature.set((block * 0x9E3779B97F4A7C15ULL) >> (64 - SIGNATURE_INDEX_BITS));
 }
 
 void PhaseDetector::update(uint64_t instructions, uint64_t mem_accesses, uint64_t misses) {
@@ -29,7 +61,7 @@ void PhaseDetector::update(uint64_t instructions, uint64_t mem_accesses, uint64_
     global_instruction_count += instructions;
 }
 
-WorkloadPhase PhaseDetector::classify_phase(const PhaseMetrics& metrics) {
+WorkloadPhase PhaseDetector::classify_phase(const PhaseMetrics& metrics, double miss_rate) {
     if (metrics.memory_accesses == 0) {
         return PHASE_COMPUTE_INTENSIVE;
     }
@@ -37,14 +69,9 @@ WorkloadPhase PhaseDetector::classify_phase(const PhaseMetrics& metrics) {
     double mem_intensity = (double)metrics.memory_accesses / 
                           (metrics.instruction_count / 1000.0);
     
-    double miss_rate = (double)metrics.cache_misses / metrics.memory_accesses;
-    
-    const double HIGH_MEM_INTENSITY = 100.0;
-    const double HIGH_MISS_RATE = 0.10;
-    
-    if (mem_intensity > HIGH_MEM_INTENSITY && miss_rate > HIGH_MISS_RATE) {
+    if (mem_intensity > mem_intensity_threshold && miss_rate > high_miss_rate) {
         return PHASE_MEMORY_INTENSIVE;
-    } else if (mem_intensity < HIGH_MEM_INTENSITY / 2) {
+    } else if (mem_intensity < mem_intensity_threshold / 2) {
         return PHASE_COMPUTE_INTENSIVE;
     } else {
         return PHASE_MIXED;
@@ -64,6 +91,36 @@ double PhaseDetector::calculate_phase_similarity(const PhaseMetrics& m1,
     return 1.0 - (miss_rate_diff + intensity_diff) / 2.0;
 }
 
+double PhaseDetector::signature_distance(const WorkingSetSignature& a, const WorkingSetSignature& b) {
+    size_t union_bits = (a | b).count();
+    if (union_bits == 0) {
+        return 0.0;
+    }
+    return (double)(a ^ b).count() / union_bits;
+}
+
+int32_t PhaseDetector::identify_phase(const WorkingSetSignature& signature) {
+    int32_t best_id = -1;
+    double best_distance = 1.0;
+    for (size_t id = 0; id < phase_signatures.size(); id++) {
+        double distance = signature_distance(phase_signatures[id], signature);
+        if (best_id < 0 || distance < best_distance) {
+            best_id = id;
+            best_distance = distance;
+        }
+    }
+    
+    // A full table folds new working sets into their nearest phase
+    if (best_id < 0 || (best_distance > signature_threshold &&
+                        phase_signatures.size() < MAX_PHASE_IDS)) {
+        phase_signatures.push_back(signature);
+        return phase_signatures.size() - 1;
+    }
+    
+    phase_signatures[best_id] = signature;
+    return best_id;
+}
+
 bool PhaseDetector::detect_phase_transition() {
     if (phase_history.empty()) {
         return false;
@@ -72,11 +129,11 @@ bool PhaseDetector::detect_phase_transition() {
     const PhaseMetrics& prev = phase_history.back();
     double similarity = calculate_phase_similarity(prev, current_metrics);
     
-    return similarity < (1.0 - PHASE_CHANGE_THRESHOLD);
+    return similarity < (1.0 - change_threshold);
 }
 
 bool PhaseDetector::check_phase_change() {
-    if (current_metrics.instruction_count < DETECTION_WINDOW) {
+    if (current_metrics.instruction_count < detection_window) {
         return false;
     }
     
@@ -85,12 +142,44 @@ bool PhaseDetector::check_phase_change() {
                                     current_metrics.memory_accesses;
         current_metrics.memory_intensity = (double)current_metrics.memory_accesses / 
                                            (current_metrics.instruction_count / 1000.0);
+        miss_rate_ewma.add(current_metrics.miss_rate);
     }
     
-    current_metrics.phase_type = classify_phase(current_metrics);
+    current_metrics.phase_type = classify_phase(current_metrics, current_metrics.miss_rate);
+    if (current_phase == PHASE_UNKNOWN || current_metrics.phase_type == last_window_phase ||
+        current_metrics.phase_type == classify_phase(current_metrics, miss_rate_ewma.get())) {
+        current_phase = current_metrics.phase_type;
+    }
+    last_window_phase = current_metrics.phase_type;
     current_metrics.timestamp = global_instruction_count;
+    current_metrics.signature_bits = current_signature.count();
     
-    bool phase_changed = detect_phase_transition();
+    // Working sets decide when addresses were recorded; otherwise fall back to
+    // comparing miss rate and intensity
+    bool phase_changed;
+    if (current_signature.any() && has_previous_signature) {
+        current_metrics.signature_distance = signature_distance(previous_signature, current_signature);
+        phase_changed = current_metrics.signature_distance > signature_threshold;
+    } else {
+        phase_changed = detect_phase_transition();
+    }
+    if (phase_changed) {
+        phase_changes++;
+    }
+    
+    phase_recurred = false;
+    if (current_signature.any()) {
+        int32_t known_phases = phase_signatures.size();
+        int32_t id = identify_phase(current_signature);
+        phase_recurred = (id < known_phases) && (id != current_phase_id);
+        current_phase_id = id;
+        current_metrics.phase_id = id;
+        predictor.observe(id, global_instruction_count);
+        
+        previous_signature = current_signature;
+        has_previous_signature = true;
+        current_signature.reset();
+    }
     
     phase_history.push_back(current_metrics);
     if (phase_history.size() > HISTORY_LENGTH) {
@@ -138,7 +227,7 @@ bool PhaseDetector::is_memory_intensive() const {
 void PhaseDetector::print_phase_info() const {
     std::cout << "\n=== Phase Detection Info ===" << std::endl;
     std::cout << "Current Phase: ";
-    switch (current_metrics.phase_type) {
+    switch (current_phase) {
         case PHASE_MEMORY_INTENSIVE: std::cout << "MEMORY_INTENSIVE"; break;
         case PHASE_COMPUTE_INTENSIVE: std::cout << "COMPUTE_INTENSIVE"; break;
         case PHASE_MIXED: std::cout << "MIXED"; break;
@@ -147,8 +236,17 @@ void PhaseDetector::print_phase_info() const {
     std::cout << std::endl;
     
     std::cout << "Memory Intensity: " << std::fixed << std::setprecision(2)
-              << current_metrics.memory_intensity << " accesses/1K inst" << std::endl;
-    std::cout << "Miss Rate: " << (current_metrics.miss_rate * 100) << "%" << std::endl;
+              << get_memory_intensity() << " accesses/1K inst" << std::endl;
+    std::cout << "Miss Rate: " << (miss_rate_ewma.get() * 100) << "% (smoothed)" << std::endl;
+    if (!phase_history.empty() && phase_history.back().signature_bits > 0) {
+        std::cout << "Working Set Signature: " << phase_history.back().signature_bits << "/"
+                  << SIGNATURE_BITS << " bits, distance "
+                  << phase_history.back().signature_distance << std::endl;
+    }
+    std::cout << "Phase Id: " << current_phase_id << " (" << phase_signatures.size()
+              << " distinct working sets)" << std::endl;
+    std::cout << "Phase Changes: " << phase_changes << " (window), "
+              << change_points << " (change-point)" << std::endl;
     std::cout << "Phase History Length: " << phase_history.size() << std::endl;
     std::cout << "Miss Rate Trend: " << get_miss_rate_trend() << std::endl;
     std::cout << "============================\n" << std::endl;
@@ -4,10 +4,21 @@
 #include <cstdint>
 #include <vector>
 #include <deque>
+#include <bitset>
+#include "change_point_detector.h"
+#include "phase_predictor.h"
+#include "metrics.h"
+#include "../config/sim_config.h"
 
-#define DETECTION_WINDOW 50000
 #define HISTORY_LENGTH 10
-#define PHASE_CHANGE_THRESHOLD 0.15
+
+// Working-set signatures: touched blocks hashed into a bit vector per window
+#define SIGNATURE_INDEX_BITS 12
+#define SIGNATURE_BITS (1 << SIGNATURE_INDEX_BITS)
+#define SIGNATURE_BLOCK_SHIFT 6
+#define MAX_PHASE_IDS 16
+
+typedef std::bitset<SIGNATURE_BITS> WorkingSetSignature;
 
 enum WorkloadPhase {
     PHASE_MEMORY_INTENSIVE,
@@ -24,38 +35,93 @@ struct PhaseMetrics {
     double memory_intensity;
     WorkloadPhase phase_type;
     uint64_t timestamp;
+    uint32_t signature_bits;
+    double signature_distance;
+    int32_t phase_id;
     
     PhaseMetrics() : instruction_count(0), memory_accesses(0), cache_misses(0),
                      miss_rate(0.0), memory_intensity(0.0), 
-                     phase_type(PHASE_UNKNOWN), timestamp(0) {}
+                     phase_type(PHASE_UNKNOWN), timestamp(0),
+                     signature_bits(0), signature_distance(0.0), phase_id(-1) {}
 };
 
 class PhaseDetector {
 private:
     std::deque<PhaseMetrics> phase_history;
     PhaseMetrics current_metrics;
+    WorkloadPhase current_phase;
+    
+    uint64_t detection_window;
+    double change_threshold;
+    double signature_threshold;
+    double mem_intensity_threshold;
+    double high_miss_rate;
     uint64_t window_start_instruction;
     uint64_t global_instruction_count;
     
-    WorkloadPhase classify_phase(const PhaseMetrics& metrics);
+    WorkingSetSignature current_signature;
+    WorkingSetSignature previous_signature;
+    bool has_previous_signature;
+    uint64_t phase_changes;
+    
+    // One representative signature per distinct working set seen so far;
+    // the index is the phase id
+    std::vector<WorkingSetSignature> phase_signatures;
+    int32_t current_phase_id;
+    bool phase_recurred;
+    PhasePredictor predictor;
+    
+    ChangePointDetector change_detector;
+    bool change_point_pending;
+    uint64_t change_points;
+    
+    // A window is classified on its own miss rate. The class only changes
+    // once a second opinion agrees: the next window, or the same window
+    // classified on the miss rate smoothed across windows.
+    Ewma miss_rate_ewma;
+    WorkloadPhase last_window_phase;
+    
+    WorkloadPhase classify_phase(const PhaseMetrics& metrics, double miss_rate);
     bool detect_phase_transition();
     double calculate_phase_similarity(const PhaseMetrics& m1, const PhaseMetrics& m2);
+    int32_t identify_phase(const WorkingSetSignature& signature);
 
 public:
-    PhaseDetector();
+    PhaseDetector(const SimConfig& config = SimConfig());
     
     void record_instruction();
     void record_memory_access(bool is_miss);
+    void record_memory_access(uint64_t address, bool is_miss);
     void update(uint64_t instructions, uint64_t mem_accesses, uint64_t misses);
     
     bool check_phase_change();
-    WorkloadPhase get_current_phase() const { return current_metrics.phase_type; }
+    
+    // Streaming test over per-access miss indicators; unlike
+    // check_phase_change() it can fire in the middle of a window
+    bool check_change_point();
+    bool has_pending_change_point() const { return change_point_pending; }
+    void set_change_sensitivity(double delta, double lambda);
+    uint64_t get_change_points() const { return change_points; }
+    // Class of the last completed window
+    WorkloadPhase get_current_phase() const { return current_phase; }
     const PhaseMetrics& get_current_metrics() const { return current_metrics; }
     
     double get_miss_rate_trend() const;
     double get_memory_intensity() const;
     bool is_memory_intensive() const;
     
+    // |a xor b| / |a or b|: 0 for identical working sets, 1 for disjoint ones
+    static double signature_distance(const WorkingSetSignature& a, const WorkingSetSignature& b);
+    const WorkingSetSignature& get_current_signature() const { return current_signature; }
+    uint64_t get_phase_changes() const { return phase_changes; }
+    
+    // Id of the working set of the last completed window (-1 before the first)
+    int32_t get_current_phase_id() const { return current_phase_id; }
+    bool did_phase_recur() const { return phase_recurred; }
+    size_t get_num_phase_ids() const { return phase_signatures.size(); }
+    const PhasePredictor& get_predictor() const { return predictor; }
+    uint64_t get_instruction_count() const { return global_instruction_count; }
+    
     void print_phase_info() const;
     std::vector<PhaseMetrics> get_history() const;
 };
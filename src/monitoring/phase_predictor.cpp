@@ -0,0 +1,106 @@
+#include "phase_predictor.h"
+#include <iostream>
+#include <iomanip>
+
+PhasePredictor::PhasePredictor()
+    : first_order(PREDICTOR_MAX_PHASES * PREDICTOR_MAX_PHASES, 0),
+      second_order(PREDICTOR_MAX_PHASES * PREDICTOR_MAX_PHASES * PREDICTOR_MAX_PHASES, 0),
+      run_total(PREDICTOR_MAX_PHASES, 0), run_count(PREDICTOR_MAX_PHASES, 0),
+      previous_phase(-1), current_phase(-1), run_start(0),
+      pending_next(-1), pending_onset(0) {
+}
+
+int32_t PhasePredictor::most_likely(const uint32_t* row) const {
+    int32_t best = -1;
+    uint32_t best_count = 0;
+    for (int32_t id = 0; id < PREDICTOR_MAX_PHASES; id++) {
+        if (row[id] > best_count) {
+            best_count = row[id];
+            best = id;
+        }
+    }
+    return best;
+}
+
+void PhasePredictor::observe(int32_t phase_id, uint64_t timestamp) {
+    if (phase_id < 0 || phase_id >= PREDICTOR_MAX_PHASES) {
+        return;
+    }
+    
+    if (current_phase < 0) {
+        current_phase = phase_id;
+        run_start = timestamp;
+        return;
+    }
+    
+    if (phase_id == current_phase) {
+        return;
+    }
+    
+    // Score the prediction made for this run before learning from it
+    stats.transitions++;
+    if (pending_next >= 0) {
+        stats.predicted++;
+        if (pending_next == phase_id) {
+            stats.next_phase_correct++;
+        }
+        if (pending_onset > 0) {
+            stats.onset_predicted++;
+            uint64_t error = timestamp > pending_onset ? timestamp - pending_onset : pending_onset - timestamp;
+            stats.onset_abs_error += error;
+            if (error <= PREDICTOR_ONSET_TOLERANCE) {
+                stats.onset_within_tolerance++;
+            }
+        }
+    }
+    
+    run_total[current_phase] += timestamp - run_start;
+    run_count[current_phase]++;
+    first_order[current_phase * PREDICTOR_MAX_PHASES + phase_id]++;
+    if (previous_phase >= 0) {
+        second_order[(previous_phase * PREDICTOR_MAX_PHASES + current_phase) * PREDICTOR_MAX_PHASES + phase_id]++;
+    }
+    
+    previous_phase = current_phase;
+    current_phase = phase_id;
+    run_start = timestamp;
+    pending_next = predict_next_phase();
+    pending_onset = predict_transition_time();
+}
+
+int32_t PhasePredictor::predict_next_phase() const {
+    if (current_phase < 0) {
+        return -1;
+    }
+    
+    if (previous_phase >= 0) {
+        const uint32_t* row = &second_order[(previous_phase * PREDICTOR_MAX_PHASES + current_phase) *
+                                            PREDICTOR_MAX_PHASES];
+        int32_t next = most_likely(row);
+        if (next >= 0) {
+            return next;
+        }
+    }
+    return most_likely(&first_order[current_phase * PREDICTOR_MAX_PHASES]);
+}
+
+uint64_t PhasePredictor::predict_transition_time() const {
+    if (current_phase < 0 || run_count[current_phase] == 0) {
+        return 0;
+    }
+    return run_start + run_total[current_phase] / run_count[current_phase];
+}
+
+void PhasePredictor::print_stats() const {
+    std::cout << "\n=== Phase Prediction ===" << std::endl;
+    std::cout << "  Transitions: " << stats.transitions << std::endl;
+    std::cout << "  Predicted: " << stats.predicted << std::endl;
+    std::cout << "  Next-Phase Accuracy: " << std::fixed << std::setprecision(2)
+              << (stats.get_accuracy() * 100) << "%" << std::endl;
+    std::cout << "  Onset Within " << PREDICTOR_ONSET_TOLERANCE << " Instructions: "
+              << (stats.get_onset_accuracy() * 100) << "%" << std::endl;
+    if (stats.onset_predicted > 0) {
+        std::cout << "  Mean Onset Error: " << stats.onset_abs_error / stats.onset_predicted
+                  << " instructions" << std::endl;
+    }
+}
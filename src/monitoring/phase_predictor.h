@@ -0,0 +1,69 @@
+#ifndef PHASE_PREDICTOR_H
+#define PHASE_PREDICTOR_H
+
+#include <cstdint>
+#include <vector>
+
+// Matches MAX_PHASE_IDS in phase_detector.h
+#define PREDICTOR_MAX_PHASES 16
+#define PREDICTOR_ONSET_TOLERANCE 50000
+
+struct PredictionStats {
+    uint64_t transitions;
+    uint64_t predicted;
+    uint64_t next_phase_correct;
+    uint64_t onset_predicted;
+    uint64_t onset_within_tolerance;
+    uint64_t onset_abs_error;
+    
+    PredictionStats() : transitions(0), predicted(0), next_phase_correct(0),
+                        onset_predicted(0), onset_within_tolerance(0), onset_abs_error(0) {}
+    
+    double get_accuracy() const {
+        return predicted > 0 ? (double)next_phase_correct / predicted : 0.0;
+    }
+    
+    double get_onset_accuracy() const {
+        return onset_predicted > 0 ? (double)onset_within_tolerance / onset_predicted : 0.0;
+    }
+};
+
+// Predicts which phase follows the current one and when. Successors come
+// from a second-order Markov table (falling back to first order while a
+// context is unseen); onsets from the mean run length of each phase.
+class PhasePredictor {
+private:
+    std::vector<uint32_t> first_order;
+    std::vector<uint32_t> second_order;
+    std::vector<uint64_t> run_total;
+    std::vector<uint64_t> run_count;
+    
+    int32_t previous_phase;
+    int32_t current_phase;
+    uint64_t run_start;
+    
+    // Prediction made when the current run began, scored at its end
+    int32_t pending_next;
+    uint64_t pending_onset;
+    
+    PredictionStats stats;
+    
+    int32_t most_likely(const uint32_t* row) const;
+
+public:
+    PhasePredictor();
+    
+    // Called once per completed window with its phase id and end timestamp
+    void observe(int32_t phase_id, uint64_t timestamp);
+    
+    int32_t predict_next_phase() const;
+    // Instruction count at which the next phase is expected to be detected
+    // (0 while the current phase has no completed run to learn from)
+    uint64_t predict_transition_time() const;
+    
+    int32_t get_current_phase() const { return current_phase; }
+    const PredictionStats& get_stats() const { return stats; }
+    void print_stats() const;
+};
+
+#endif
@@ -0,0 +1,87 @@
+#include "profiler.h"
+
+#ifdef VC_PROFILE
+
+#include <iostream>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+
+static const char* const SITE_NAMES[PROF_NUM_SITES] = {
+    "CacheHierarchySimulator::access_memory",
+    "SetAssociativeCache::find_way",
+    "VictimCache::lookup",
+    "VictimCache::insert_smart",
+    "VictimCache::find_victim_entry",
+    "VictimCache::predict_reuse_potential",
+    "PhaseDetector::record_memory_access",
+    "AdaptiveController::update",
+    "AdaptiveController::check_and_adapt",
+};
+
+static const char* const COUNTER_NAMES[PROF_NUM_COUNTERS] = {
+    "Victim entries scanned",
+    "Set-associative ways scanned",
+};
+
+static std::mutex registry_mutex;
+static std::vector<ProfileBuffer*> registry;
+static const uint64_t profile_epoch = profile_now();
+
+ProfileBuffer& profile_thread_buffer() {
+    thread_local ProfileBuffer* buffer = nullptr;
+    if (!buffer) {
+        buffer = new ProfileBuffer();
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        registry.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void profile_report() {
+    uint64_t elapsed = profile_now() - profile_epoch;
+    ProfileBuffer total = ProfileBuffer();
+    size_t threads = 0;
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        threads = registry.size();
+        for (const ProfileBuffer* buffer : registry) {
+            for (int s = 0; s < PROF_NUM_SITES; s++) {
+                total.cycles[s] += buffer->cycles[s];
+                total.calls[s] += buffer->calls[s];
+            }
+            for (int c = 0; c < PROF_NUM_COUNTERS; c++) {
+                total.counts[c] += buffer->counts[c];
+            }
+        }
+    }
+    
+    // Sites nest (access_memory contains the rest), so the shares are
+    // inclusive and do not add up to 100%
+    std::ios_base::fmtflags saved_flags = std::cout.flags();
+    std::cout << std::noshowpos << "\n=== Hot-Path Profile (" << threads << " thread(s), "
+              << elapsed << " cycles since start) ===" << std::endl;
+    std::cout << std::left << std::setw(40) << "Function" << std::right << std::setw(12) << "Calls"
+              << std::setw(16) << "Cycles" << std::setw(12) << "Cyc/call" << std::setw(10) << "Share" << std::endl;
+    std::cout << std::string(90, '-') << std::endl;
+    for (int s = 0; s < PROF_NUM_SITES; s++) {
+        if (total.calls[s] == 0) {
+            continue;
+        }
+        std::cout << std::left << std::setw(40) << SITE_NAMES[s] << std::right
+                  << std::setw(12) << total.calls[s] << std::setw(16) << total.cycles[s]
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(12) << (double)total.cycles[s] / total.calls[s]
+                  << std::setw(9) << (elapsed > 0 ? 100.0 * total.cycles[s] / elapsed : 0.0) << "%" << std::endl;
+    }
+    for (int c = 0; c < PROF_NUM_COUNTERS; c++) {
+        if (total.counts[c] > 0) {
+            std::cout << std::left << std::setw(40) << COUNTER_NAMES[c] << std::right
+                      << std::setw(12) << total.counts[c] << std::endl;
+        }
+    }
+    std::cout << "==========================================" << std::endl;
+    std::cout.flags(saved_flags);
+}
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// Hot-path profiling, built only with -DVC_PROFILE (`make profile`).
+// Otherwise every macro below expands to an empty statement, so the
+// instrumented functions compile exactly as before.
+//
+// VC_PROFILE_SCOPE(site) times the rest of the enclosing block in TSC cycles;
+// VC_PROFILE_COUNT(counter, n) adds n to an event counter. Both accumulate
+// into a buffer owned by the calling thread, so there is no locking on the
+// hot path. VC_PROFILE_REPORT_AT_EXIT() at the top of main() prints the
+// summed breakdown when main returns.
+
+enum ProfileSite {
+    PROF_ACCESS_MEMORY,
+    PROF_FIND_WAY,
+    PROF_VICTIM_LOOKUP,
+    PROF_VICTIM_INSERT,
+    PROF_FIND_VICTIM_ENTRY,
+    PROF_PREDICT_REUSE,
+    PROF_PHASE_RECORD,
+    PROF_CONTROLLER_UPDATE,
+    PROF_CONTROLLER_ADAPT,
+    PROF_NUM_SITES
+};
+
+enum ProfileCounter {
+    PROF_VICTIM_ENTRIES_SCANNED,
+    PROF_CACHE_WAYS_SCANNED,
+    PROF_NUM_COUNTERS
+};
+
+#ifdef VC_PROFILE
+
+#include <cstdint>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+struct ProfileBuffer {
+    uint64_t cycles[PROF_NUM_SITES];
+    uint64_t calls[PROF_NUM_SITES];
+    uint64_t counts[PROF_NUM_COUNTERS];
+};
+
+// The calling thread's buffer, allocated and registered on first use. Buffers
+// outlive their threads so the report still sees work done by finished ones.
+ProfileBuffer& profile_thread_buffer();
+void profile_report();
+
+inline uint64_t profile_now() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+class ProfileScope {
+private:
+    ProfileSite site;
+    uint64_t start;
+
+public:
+    explicit ProfileScope(ProfileSite s) : site(s), start(profile_now()) {}
+    ~ProfileScope() {
+        ProfileBuffer& buffer = profile_thread_buffer();
+        buffer.cycles[site] += profile_now() - start;
+        buffer.calls[site]++;
+    }
+};
+
+struct ProfileReportAtExit {
+    ~ProfileReportAtExit() { profile_report(); }
+};
+
+#define VC_PROFILE_JOIN2(a, b) a##b
+#define VC_PROFILE_JOIN(a, b) VC_PROFILE_JOIN2(a, b)
+#define VC_PROFILE_SCOPE(site) ProfileScope VC_PROFILE_JOIN(profile_scope_, __LINE__)(site)
+#define VC_PROFILE_COUNT(counter, n) (profile_thread_buffer().counts[counter] += (n))
+#define VC_PROFILE_REPORT_AT_EXIT() ProfileReportAtExit profile_report_at_exit
+
+#else
+
+#define VC_PROFILE_SCOPE(site) do {} while (0)
+#define VC_PROFILE_COUNT(counter, n) do {} while (0)
+#define VC_PROFILE_REPORT_AT_EXIT() do {} while (0)
+
+#endif
+
+#endif
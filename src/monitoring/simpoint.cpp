@@ -0,0 +1,236 @@
+#include "simpoint.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <random>
+#include <limits>
+#include <algorithm>
+#include <unordered_set>
+
+SimPointAnalyzer::SimPointAnalyzer(uint64_t interval, uint32_t clusters)
+    : interval_length(interval > 0 ? interval : SIMPOINT_INTERVAL_LENGTH),
+      max_clusters(clusters > 0 ? clusters : 1), trace_length(0) {
+}
+
+void SimPointAnalyzer::build_signatures(const std::vector<uint64_t>& trace) {
+    signatures.clear();
+    interval_lengths.clear();
+    std::unordered_set<uint64_t> touched_blocks;
+
+    for (uint64_t start = 0; start < trace.size(); start += interval_length) {
+        uint64_t end = std::min<uint64_t>(start + interval_length, trace.size());
+        std::vector<double> histogram(SIMPOINT_SIGNATURE_DIMS, 0.0);
+
+        for (uint64_t i = start; i < end; i++) {
+            uint64_t region = trace[i] >> SIMPOINT_REGION_SHIFT;
+            histogram[region % SIMPOINT_SIGNATURE_BINS] += 1.0;
+
+            // Cold-start intervals look like any other by region mix alone, but
+            // their compulsory misses dominate MPKI, so first touches get a bin
+            if (touched_blocks.insert(trace[i] >> SIMPOINT_BLOCK_SHIFT).second) {
+                histogram[SIMPOINT_SIGNATURE_BINS] += SIMPOINT_FIRST_TOUCH_WEIGHT;
+            }
+        }
+
+        // Normalise so that a short tail interval is comparable to full ones
+        double length = (double)(end - start);
+        for (double& bin : histogram) {
+            bin /= length;
+        }
+
+        signatures.push_back(histogram);
+        interval_lengths.push_back(end - start);
+    }
+}
+
+double SimPointAnalyzer::distance(const std::vector<double>& a, const std::vector<double>& b) {
+    double sum = 0.0;
+    for (size_t i = 0; i < a.size(); i++) {
+        double d = a[i] - b[i];
+        sum += d * d;
+    }
+    return sum;
+}
+
+void SimPointAnalyzer::init_centroids(uint32_t k) {
+    // k-means++ seeding with a fixed seed so reruns pick the same points
+    std::mt19937_64 rng(SIMPOINT_SEED);
+    centroids.clear();
+
+    std::uniform_int_distribution<size_t> pick(0, signatures.size() - 1);
+    centroids.push_back(signatures[pick(rng)]);
+
+    std::vector<double> min_dist(signatures.size(), std::numeric_limits<double>::max());
+    while (centroids.size() < k) {
+        double total = 0.0;
+        for (size_t i = 0; i < signatures.size(); i++) {
+            min_dist[i] = std::min(min_dist[i], distance(signatures[i], centroids.back()));
+            total += min_dist[i];
+        }
+
+        if (total <= 0.0) {
+            break;
+        }
+
+        std::uniform_real_distribution<double> roll(0.0, total);
+        double target = roll(rng);
+        size_t chosen = signatures.size() - 1;
+        for (size_t i = 0; i < signatures.size(); i++) {
+            target -= min_dist[i];
+            if (target <= 0.0) {
+                chosen = i;
+                break;
+            }
+        }
+        centroids.push_back(signatures[chosen]);
+    }
+}
+
+void SimPointAnalyzer::run_kmeans(uint32_t k) {
+    init_centroids(k);
+    assignments.assign(signatures.size(), 0);
+
+    for (uint32_t iter = 0; iter < SIMPOINT_KMEANS_ITERATIONS; iter++) {
+        bool changed = false;
+
+        for (size_t i = 0; i < signatures.size(); i++) {
+            uint32_t best = 0;
+            double best_dist = std::numeric_limits<double>::max();
+            for (uint32_t c = 0; c < centroids.size(); c++) {
+                double d = distance(signatures[i], centroids[c]);
+                if (d < best_dist) {
+                    best_dist = d;
+                    best = c;
+                }
+            }
+            if (assignments[i] != best) {
+                assignments[i] = best;
+                changed = true;
+            }
+        }
+
+        std::vector<std::vector<double>> sums(centroids.size(),
+                                              std::vector<double>(SIMPOINT_SIGNATURE_DIMS, 0.0));
+        std::vector<uint64_t> counts(centroids.size(), 0);
+        for (size_t i = 0; i < signatures.size(); i++) {
+            counts[assignments[i]]++;
+            for (size_t b = 0; b < SIMPOINT_SIGNATURE_DIMS; b++) {
+                sums[assignments[i]][b] += signatures[i][b];
+            }
+        }
+
+        for (uint32_t c = 0; c < centroids.size(); c++) {
+            if (counts[c] == 0) {
+                continue;  // empty cluster keeps its old centroid
+            }
+            for (size_t b = 0; b < SIMPOINT_SIGNATURE_DIMS; b++) {
+                centroids[c][b] = sums[c][b] / counts[c];
+            }
+        }
+
+        if (!changed && iter > 0) {
+            break;
+        }
+    }
+}
+
+void SimPointAnalyzer::select_representatives() {
+    simpoints.clear();
+
+    for (uint32_t c = 0; c < centroids.size(); c++) {
+        SimPoint point;
+        point.cluster = c;
+        double best_dist = std::numeric_limits<double>::max();
+        bool best_is_full = false;
+        bool found = false;
+
+        for (size_t i = 0; i < signatures.size(); i++) {
+            if (assignments[i] != c) {
+                continue;
+            }
+            point.cluster_intervals++;
+            point.cluster_accesses += interval_lengths[i];
+
+            // Prefer full-length intervals; the trailing partial one is a fallback
+            bool is_full = interval_lengths[i] == interval_length;
+            double d = distance(signatures[i], centroids[c]);
+            if (!found || (is_full && !best_is_full) ||
+                (is_full == best_is_full && d < best_dist)) {
+                best_dist = d;
+                best_is_full = is_full;
+                point.interval_index = i;
+                found = true;
+            }
+        }
+
+        if (!found) {
+            continue;
+        }
+
+        point.start = point.interval_index * interval_length;
+        point.length = interval_lengths[point.interval_index];
+        point.weight = (double)point.cluster_accesses / trace_length;
+        simpoints.push_back(point);
+    }
+
+    std::sort(simpoints.begin(), simpoints.end(),
+              [](const SimPoint& a, const SimPoint& b) { return a.start < b.start; });
+}
+
+const std::vector<SimPoint>& SimPointAnalyzer::analyze(const std::vector<uint64_t>& trace) {
+    trace_length = trace.size();
+    simpoints.clear();
+    if (trace.empty()) {
+        return simpoints;
+    }
+
+    build_signatures(trace);
+    uint32_t k = std::min<uint64_t>(max_clusters, signatures.size());
+    run_kmeans(k);
+    select_representatives();
+
+    std::cout << "[SimPoint] " << signatures.size() << " intervals of " << interval_length
+              << " accesses -> " << simpoints.size() << " representatives" << std::endl;
+    return simpoints;
+}
+
+void SimPointAnalyzer::print_simpoints() const {
+    std::cout << "\n=== SimPoint Representatives ===" << std::endl;
+    std::cout << std::setw(10) << "Cluster"
+              << std::setw(12) << "Interval"
+              << std::setw(12) << "Start"
+              << std::setw(12) << "Members"
+              << std::setw(10) << "Weight" << std::endl;
+    std::cout << std::string(56, '-') << std::endl;
+
+    for (const auto& point : simpoints) {
+        std::cout << std::setw(10) << point.cluster
+                  << std::setw(12) << point.interval_index
+                  << std::setw(12) << point.start
+                  << std::setw(12) << point.cluster_intervals
+                  << std::setw(10) << std::fixed << std::setprecision(3) << point.weight
+                  << std::endl;
+    }
+    std::cout << "================================\n" << std::endl;
+}
+
+void SimPointAnalyzer::export_simpoints(const std::string& filename) const {
+    std::ofstream outfile(filename);
+    if (!outfile.is_open()) {
+        std::cerr << "Failed to open " << filename << " for writing" << std::endl;
+        return;
+    }
+
+    outfile << "cluster,interval,start,length,members,weight\n";
+    for (const auto& point : simpoints) {
+        outfile << point.cluster << ","
+                << point.interval_index << ","
+                << point.start << ","
+                << point.length << ","
+                << point.cluster_intervals << ","
+                << point.weight << "\n";
+    }
+
+    outfile.close();
+    std::cout << "[SimPoint] Representatives exported to " << filename << std::endl;
+}
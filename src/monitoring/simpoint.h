@@ -0,0 +1,66 @@
+#ifndef SIMPOINT_H
+#define SIMPOINT_H
+
+#include <cstdint>
+#include <vector>
+#include <string>
+
+#define SIMPOINT_INTERVAL_LENGTH 10000
+#define SIMPOINT_SIGNATURE_BINS 64
+#define SIMPOINT_SIGNATURE_DIMS (SIMPOINT_SIGNATURE_BINS + 1)
+#define SIMPOINT_FIRST_TOUCH_WEIGHT 4.0
+#define SIMPOINT_REGION_SHIFT 10
+#define SIMPOINT_BLOCK_SHIFT 6
+#define SIMPOINT_MAX_CLUSTERS 8
+#define SIMPOINT_KMEANS_ITERATIONS 50
+#define SIMPOINT_WARMUP_LENGTH 10000
+#define SIMPOINT_SEED 683
+
+// One representative interval chosen by the offline pass. The weight is the
+// fraction of the whole trace (in accesses) that its cluster stands for.
+struct SimPoint {
+    uint64_t interval_index;
+    uint64_t start;
+    uint64_t length;
+    uint32_t cluster;
+    uint64_t cluster_intervals;
+    uint64_t cluster_accesses;
+    double weight;
+
+    SimPoint() : interval_index(0), start(0), length(0), cluster(0),
+                 cluster_intervals(0), cluster_accesses(0), weight(0.0) {}
+};
+
+class SimPointAnalyzer {
+private:
+    uint64_t interval_length;
+    uint32_t max_clusters;
+    uint64_t trace_length;
+
+    std::vector<std::vector<double>> signatures;
+    std::vector<uint64_t> interval_lengths;
+    std::vector<std::vector<double>> centroids;
+    std::vector<uint32_t> assignments;
+    std::vector<SimPoint> simpoints;
+
+    void build_signatures(const std::vector<uint64_t>& trace);
+    void init_centroids(uint32_t k);
+    void run_kmeans(uint32_t k);
+    void select_representatives();
+    static double distance(const std::vector<double>& a, const std::vector<double>& b);
+
+public:
+    SimPointAnalyzer(uint64_t interval = SIMPOINT_INTERVAL_LENGTH,
+                     uint32_t clusters = SIMPOINT_MAX_CLUSTERS);
+
+    const std::vector<SimPoint>& analyze(const std::vector<uint64_t>& trace);
+
+    const std::vector<SimPoint>& get_simpoints() const { return simpoints; }
+    uint64_t get_num_intervals() const { return signatures.size(); }
+    uint64_t get_interval_length() const { return interval_length; }
+
+    void print_simpoints() const;
+    void export_simpoints(const std::string& filename) const;
+};
+
+#endif
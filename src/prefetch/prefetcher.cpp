@@ -0,0 +1,192 @@
+#include "prefetcher.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+
+void Prefetcher::print_stats() const {
+    std::cout << "\n=== " << name << " Prefetcher Statistics ===" << std::endl;
+    std::cout << "  Issued: " << stats.issued << std::endl;
+    std::cout << "  Filtered (already present): " << stats.filtered << std::endl;
+    std::cout << "  Useful: " << stats.useful << std::endl;
+    std::cout << "  Late: " << stats.late << " (" << stats.late_cycles << " cycles waited)" << std::endl;
+    std::cout << "  Memory Fetches: " << stats.memory_fetches << std::endl;
+    std::cout << "  Accuracy: " << std::fixed << std::setprecision(2)
+              << (stats.get_accuracy() * 100) << "%" << std::endl;
+    std::cout << "  Coverage: " << (stats.get_coverage() * 100) << "%" << std::endl;
+    std::cout << "  Timeliness: " << (stats.get_timeliness() * 100) << "%" << std::endl;
+}
+
+Prefetcher* Prefetcher::create(PrefetcherType type, uint32_t degree) {
+    switch (type) {
+        case PREFETCHER_NEXT_LINE: return new NextLinePrefetcher(degree);
+        case PREFETCHER_STRIDE: return new StridePrefetcher(degree);
+        case PREFETCHER_STREAM: return new StreamPrefetcher(degree);
+        case PREFETCHER_NONE:
+        default:
+            return nullptr;
+    }
+}
+
+bool Prefetcher::parse_type(const std::string& type_name, PrefetcherType& type) {
+    if (type_name == "none") {
+        type = PREFETCHER_NONE;
+    } else if (type_name == "nextline" || type_name == "next-line") {
+        type = PREFETCHER_NEXT_LINE;
+    } else if (type_name == "stride") {
+        type = PREFETCHER_STRIDE;
+    } else if (type_name == "stream") {
+        type = PREFETCHER_STREAM;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void NextLinePrefetcher::observe(uint64_t address, bool miss, std::vector<uint64_t>& candidates) {
+    if (!miss) {
+        return;
+    }
+
+    uint64_t block = address >> PREFETCH_BLOCK_SHIFT;
+    for (uint32_t k = 1; k <= degree; k++) {
+        candidates.push_back((block + k) << PREFETCH_BLOCK_SHIFT);
+    }
+}
+
+StridePrefetcher::StridePrefetcher(uint32_t prefetch_degree)
+    : Prefetcher("Stride", prefetch_degree) {
+    table.resize(STRIDE_TABLE_SIZE);
+}
+
+void StridePrefetcher::observe(uint64_t address, bool /* miss */, std::vector<uint64_t>& candidates) {
+    uint64_t block = address >> PREFETCH_BLOCK_SHIFT;
+    uint64_t region = address >> STRIDE_REGION_SHIFT;
+    StrideEntry& entry = table[region % STRIDE_TABLE_SIZE];
+
+    if (!entry.valid || entry.region != region) {
+        entry.valid = true;
+        entry.region = region;
+        entry.last_block = block;
+        entry.stride = 0;
+        entry.confidence = 0;
+        return;
+    }
+
+    int64_t stride = (int64_t)block - (int64_t)entry.last_block;
+    if (stride == 0) {
+        return;
+    }
+
+    if (stride == entry.stride) {
+        if (entry.confidence < STRIDE_CONFIDENCE_MAX) {
+            entry.confidence++;
+        }
+    } else {
+        if (entry.confidence > 0) {
+            entry.confidence--;
+        }
+        if (entry.confidence == 0) {
+            entry.stride = stride;
+        }
+    }
+    entry.last_block = block;
+
+    if (entry.confidence >= STRIDE_CONFIDENCE_THRESHOLD) {
+        for (uint32_t k = 1; k <= degree; k++) {
+            int64_t target = (int64_t)block + entry.stride * k;
+            if (target < 0) {
+                break;
+            }
+            candidates.push_back((uint64_t)target << PREFETCH_BLOCK_SHIFT);
+        }
+    }
+}
+
+StreamPrefetcher::StreamPrefetcher(uint32_t prefetch_degree)
+    : Prefetcher("Stream", prefetch_degree), global_lru(0) {
+    streams.resize(STREAM_TABLE_SIZE);
+}
+
+int32_t StreamPrefetcher::find_stream(uint64_t block) const {
+    for (uint32_t i = 0; i < streams.size(); i++) {
+        if (!streams[i].valid) {
+            continue;
+        }
+        int64_t distance = (int64_t)block - (int64_t)streams[i].last_block;
+        if (std::llabs(distance) <= STREAM_TRAIN_WINDOW) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+uint32_t StreamPrefetcher::find_lru_stream() const {
+    uint32_t lru = 0;
+    for (uint32_t i = 0; i < streams.size(); i++) {
+        if (!streams[i].valid) {
+            return i;
+        }
+        if (streams[i].lru_counter < streams[lru].lru_counter) {
+            lru = i;
+        }
+    }
+    return lru;
+}
+
+void StreamPrefetcher::observe(uint64_t address, bool miss, std::vector<uint64_t>& candidates) {
+    if (!miss) {
+        return;
+    }
+
+    uint64_t block = address >> PREFETCH_BLOCK_SHIFT;
+    int32_t idx = find_stream(block);
+
+    if (idx < 0) {
+        StreamEntry& entry = streams[find_lru_stream()];
+        entry = StreamEntry();
+        entry.valid = true;
+        entry.last_block = block;
+        entry.next_prefetch = block;
+        entry.lru_counter = global_lru++;
+        return;
+    }
+
+    StreamEntry& entry = streams[idx];
+    entry.lru_counter = global_lru++;
+
+    int64_t diff = (int64_t)block - (int64_t)entry.last_block;
+    if (diff == 0) {
+        return;
+    }
+
+    int32_t direction = diff > 0 ? 1 : -1;
+    if (direction == entry.direction) {
+        entry.confirmations++;
+    } else {
+        entry.direction = direction;
+        entry.confirmations = 1;
+        entry.next_prefetch = block;
+    }
+    entry.last_block = block;
+
+    if (entry.confirmations < STREAM_CONFIRMATIONS) {
+        return;
+    }
+
+    // Keep the prefetch head up to STREAM_PREFETCH_DISTANCE blocks ahead of the
+    // demand stream, issuing at most `degree` blocks per trigger
+    int64_t head = (int64_t)entry.next_prefetch;
+    if ((head - (int64_t)block) * direction <= 0) {
+        head = (int64_t)block + direction;
+    }
+    int64_t limit = (int64_t)block + direction * STREAM_PREFETCH_DISTANCE;
+
+    for (uint32_t issued = 0; issued < degree && (limit - head) * direction >= 0; issued++) {
+        if (head < 0) {
+            break;
+        }
+        candidates.push_back((uint64_t)head << PREFETCH_BLOCK_SHIFT);
+        head += direction;
+    }
+    entry.next_prefetch = head < 0 ? 0 : (uint64_t)head;
+}
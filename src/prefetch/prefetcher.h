@@ -0,0 +1,137 @@
+#ifndef PREFETCHER_H
+#define PREFETCHER_H
+
+#include <cstdint>
+#include <vector>
+#include <string>
+
+#define PREFETCH_BLOCK_SHIFT 6
+#define PREFETCH_DEGREE 2
+
+#define STRIDE_TABLE_SIZE 64
+#define STRIDE_REGION_SHIFT 12
+#define STRIDE_CONFIDENCE_THRESHOLD 2
+#define STRIDE_CONFIDENCE_MAX 3
+
+#define STREAM_TABLE_SIZE 8
+#define STREAM_TRAIN_WINDOW 8
+#define STREAM_CONFIRMATIONS 2
+#define STREAM_PREFETCH_DISTANCE 4
+
+enum PrefetcherType {
+    PREFETCHER_NONE,
+    PREFETCHER_NEXT_LINE,
+    PREFETCHER_STRIDE,
+    PREFETCHER_STREAM
+};
+
+enum PrefetchLevel {
+    PREFETCH_AT_L1,
+    PREFETCH_AT_L2
+};
+
+struct PrefetchStats {
+    uint64_t issued;
+    uint64_t filtered;
+    uint64_t useful;
+    uint64_t late;
+    uint64_t late_cycles;
+    uint64_t uncovered_misses;
+    uint64_t memory_fetches;
+
+    PrefetchStats() : issued(0), filtered(0), useful(0), late(0), late_cycles(0),
+                      uncovered_misses(0), memory_fetches(0) {}
+
+    double get_accuracy() const {
+        return issued > 0 ? (double)useful / issued : 0.0;
+    }
+
+    double get_coverage() const {
+        return (useful + uncovered_misses) > 0 ?
+            (double)useful / (useful + uncovered_misses) : 0.0;
+    }
+
+    double get_timeliness() const {
+        return useful > 0 ? 1.0 - (double)late / useful : 0.0;
+    }
+};
+
+class Prefetcher {
+protected:
+    std::string name;
+    uint32_t degree;
+    PrefetchStats stats;
+
+public:
+    Prefetcher(const std::string& prefetcher_name, uint32_t prefetch_degree)
+        : name(prefetcher_name), degree(prefetch_degree) {}
+    virtual ~Prefetcher() {}
+
+    // Trains on one demand access at the attached level and appends the block
+    // addresses worth prefetching. A first hit on a prefetched block should be
+    // reported as a miss so that streams keep running ahead (tagged prefetch).
+    virtual void observe(uint64_t address, bool miss, std::vector<uint64_t>& candidates) = 0;
+
+    const std::string& get_name() const { return name; }
+    PrefetchStats& get_stats() { return stats; }
+    const PrefetchStats& get_stats() const { return stats; }
+    void print_stats() const;
+
+    static Prefetcher* create(PrefetcherType type, uint32_t degree = PREFETCH_DEGREE);
+    // False, leaving `type` alone, for an unknown name
+    static bool parse_type(const std::string& type_name, PrefetcherType& type);
+};
+
+class NextLinePrefetcher : public Prefetcher {
+public:
+    NextLinePrefetcher(uint32_t prefetch_degree = PREFETCH_DEGREE)
+        : Prefetcher("Next-Line", prefetch_degree) {}
+    void observe(uint64_t address, bool miss, std::vector<uint64_t>& candidates) override;
+};
+
+// Without PCs the stride table is indexed by address region instead
+struct StrideEntry {
+    uint64_t region;
+    uint64_t last_block;
+    int64_t stride;
+    uint32_t confidence;
+    bool valid;
+
+    StrideEntry() : region(0), last_block(0), stride(0), confidence(0), valid(false) {}
+};
+
+class StridePrefetcher : public Prefetcher {
+private:
+    std::vector<StrideEntry> table;
+
+public:
+    StridePrefetcher(uint32_t prefetch_degree = PREFETCH_DEGREE);
+    void observe(uint64_t address, bool miss, std::vector<uint64_t>& candidates) override;
+};
+
+struct StreamEntry {
+    uint64_t last_block;
+    uint64_t next_prefetch;
+    int32_t direction;
+    uint32_t confirmations;
+    uint64_t lru_counter;
+    bool valid;
+
+    StreamEntry() : last_block(0), next_prefetch(0), direction(0), confirmations(0),
+                    lru_counter(0), valid(false) {}
+};
+
+class StreamPrefetcher : public Prefetcher {
+private:
+    std::vector<StreamEntry> streams;
+    uint64_t global_lru;
+
+    int32_t find_stream(uint64_t block) const;
+    uint32_t find_lru_stream() const;
+
+public:
+    StreamPrefetcher(uint32_t prefetch_degree = PREFETCH_DEGREE);
+    void observe(uint64_t address, bool miss, std::vector<uint64_t>& candidates) override;
+};
+
+#endif
@@ -0,0 +1,426 @@
+#include "cache_simulator.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <limits>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+
+// Random search over AUTOTUNE_CANDIDATES configurations, narrowed by
+// successive halving: every candidate runs on the first
+// 1/AUTOTUNE_MIN_PREFIX_FRACTION of the trace, the best 1/AUTOTUNE_ETA advance
+// to a prefix AUTOTUNE_ETA times longer, until the survivors run all of it.
+#define AUTOTUNE_CANDIDATES 32
+#define AUTOTUNE_TRACE_LENGTH 500000
+#define AUTOTUNE_ETA 2
+#define AUTOTUNE_MIN_PREFIX_FRACTION 8
+#define AUTOTUNE_SENSITIVITY_POINTS 5
+
+struct TunableParam {
+    const char* key;
+    double min_value;
+    double max_value;
+    bool integer;
+};
+
+static const TunableParam TUNABLE_PARAMS[] = {
+    {"adaptive.hit_rate_high", 0.02, 0.30, false},
+    {"adaptive.hit_rate_low", 0.00, 0.10, false},
+    {"adaptive.occupancy_high", 0.50, 0.98, false},
+    {"adaptive.occupancy_low", 0.05, 0.50, false},
+    {"adaptive.interval", 10000, 100000, true},
+    {"adaptive.size_step", 8, 64, true},
+    {"victim.reuse_threshold", 0, 6, true},
+    {"victim.streaming_threshold", 2, 32, true},
+    {"phase.window", 10000, 100000, true},
+    {"phase.change_threshold", 0.05, 0.40, false},
+};
+static const size_t NUM_TUNABLE_PARAMS = sizeof(TUNABLE_PARAMS) / sizeof(TUNABLE_PARAMS[0]);
+
+typedef std::vector<double> Candidate;
+
+struct TuningJob {
+    SimConfig config;
+    uint64_t length;
+};
+
+static std::string format_value(const TunableParam& param, double value) {
+    std::ostringstream out;
+    if (param.integer) {
+        out << (uint64_t)value;
+    } else {
+        out << std::fixed << std::setprecision(4) << value;
+    }
+    return out.str();
+}
+
+// False when the values break a SimConfig constraint (e.g. low above high)
+static bool build_config(const SimConfig& base, const Candidate& values, SimConfig& config) {
+    config = base;
+    for (size_t p = 0; p < NUM_TUNABLE_PARAMS; p++) {
+        if (!config.set(TUNABLE_PARAMS[p].key, format_value(TUNABLE_PARAMS[p], values[p]))) {
+            return false;
+        }
+    }
+    return config.validate(false);
+}
+
+static Candidate sample_candidate(std::mt19937_64& rng) {
+    Candidate values(NUM_TUNABLE_PARAMS);
+    for (size_t p = 0; p < NUM_TUNABLE_PARAMS; p++) {
+        const TunableParam& param = TUNABLE_PARAMS[p];
+        if (param.integer) {
+            std::uniform_int_distribution<uint64_t> dist(param.min_value, param.max_value);
+            values[p] = dist(rng);
+        } else {
+            std::uniform_real_distribution<double> dist(param.min_value, param.max_value);
+            values[p] = dist(rng);
+        }
+    }
+    return values;
+}
+
+static Candidate config_values(const SimConfig& config) {
+    std::ostringstream text;
+    config.write(text);
+    
+    Candidate values(NUM_TUNABLE_PARAMS, 0.0);
+    std::istringstream in(text.str());
+    std::string key, equals;
+    double value;
+    while (in >> key >> equals >> value) {
+        for (size_t p = 0; p < NUM_TUNABLE_PARAMS; p++) {
+            if (key == TUNABLE_PARAMS[p].key) {
+                values[p] = value;
+            }
+        }
+    }
+    return values;
+}
+
+// AMAT of the adaptive hierarchy over the first `length` accesses
+static double evaluate(const SimConfig& config, const std::vector<uint64_t>& trace, uint64_t length) {
+    CacheHierarchySimulator sim(true, true, config);
+    length = std::min<uint64_t>(length, trace.size());
+    for (uint64_t i = 0; i < length; i++) {
+        sim.access_memory(trace[i], WorkloadGenerator::access_type(i, DEFAULT_WRITE_RATIO));
+        sim.simulate_instruction();
+    }
+    return sim.get_amat();
+}
+
+// Each worker process takes every jobs-th job, runs it with stdout silenced
+// and sends (index, AMAT) pairs back over a pipe. Separate processes keep the
+// simulators' logging and state apart; the trace is shared copy-on-write.
+// False if any job's result never arrived; its score is then left infinite.
+static bool run_jobs(const std::vector<TuningJob>& jobs, const std::vector<uint64_t>& trace,
+                     uint32_t workers, std::vector<double>& scores) {
+    scores.assign(jobs.size(), std::numeric_limits<double>::infinity());
+    std::vector<bool> received(jobs.size(), false);
+    workers = std::max<uint32_t>(1, std::min<uint32_t>(workers, jobs.size()));
+    std::cout.flush();
+    
+    std::vector<int> read_ends;
+    std::vector<pid_t> children;
+    for (uint32_t w = 0; w < workers; w++) {
+        int fds[2];
+        pid_t pid = -1;
+        if (pipe(fds) == 0) {
+            pid = fork();
+        }
+        if (pid < 0) {
+            std::cerr << "[Autotune] Cannot start worker " << w << "; running its jobs inline" << std::endl;
+            for (size_t j = w; j < jobs.size(); j += workers) {
+                scores[j] = evaluate(jobs[j].config, trace, jobs[j].length);
+                received[j] = true;
+            }
+            continue;
+        }
+        if (pid == 0) {
+            close(fds[0]);
+            int devnull = open("/dev/null", O_WRONLY);
+            if (devnull >= 0) {
+                dup2(devnull, STDOUT_FILENO);
+            }
+            for (size_t j = w; j < jobs.size(); j += workers) {
+                double result[2] = {(double)j, evaluate(jobs[j].config, trace, jobs[j].length)};
+                if (write(fds[1], result, sizeof(result)) != sizeof(result)) {
+                    _exit(1);
+                }
+            }
+            std::cout.flush();
+            _exit(0);
+        }
+        close(fds[1]);
+        read_ends.push_back(fds[0]);
+        children.push_back(pid);
+    }
+    
+    for (int fd : read_ends) {
+        double result[2];
+        while (read(fd, result, sizeof(result)) == sizeof(result)) {
+            size_t j = (size_t)result[0];
+            if (j < jobs.size()) {
+                scores[j] = result[1];
+                received[j] = true;
+            }
+        }
+        close(fd);
+    }
+    for (pid_t pid : children) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            std::cerr << "[Autotune] Worker " << pid << " failed" << std::endl;
+        }
+    }
+    
+    size_t lost = std::count(received.begin(), received.end(), false);
+    if (lost > 0) {
+        std::cerr << "[Autotune] " << lost << " of " << jobs.size() << " jobs returned no result" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+struct TuningResult {
+    std::string workload;
+    double default_amat;
+    double best_amat;
+    SimConfig best_config;
+    uint64_t simulated_accesses;
+    std::vector<double> sensitivity_low;
+    std::vector<double> sensitivity_high;
+};
+
+// False if a round lost jobs; a missing score would rank its candidate
+// arbitrarily, so the workload is abandoned rather than reported
+static bool tune_workload(const std::string& workload, const std::vector<uint64_t>& trace,
+                          const SimConfig& base, uint32_t num_candidates, uint32_t workers,
+                          std::mt19937_64& rng, TuningResult& result) {
+    result.workload = workload;
+    result.simulated_accesses = 0;
+    
+    std::vector<SimConfig> candidates;
+    uint32_t attempts = 0;
+    while (candidates.size() < num_candidates && attempts < num_candidates * 100) {
+        SimConfig config;
+        if (build_config(base, sample_candidate(rng), config)) {
+            candidates.push_back(config);
+        }
+        attempts++;
+    }
+    
+    // The defaults compete in every round, so tuning never reports a loss
+    candidates.push_back(base);
+    std::vector<size_t> alive(candidates.size());
+    for (size_t i = 0; i < alive.size(); i++) {
+        alive[i] = i;
+    }
+    
+    uint64_t length = std::max<uint64_t>(1, trace.size() / AUTOTUNE_MIN_PREFIX_FRACTION);
+    std::vector<double> scores(candidates.size(), std::numeric_limits<double>::infinity());
+    while (true) {
+        std::vector<TuningJob> jobs;
+        for (size_t index : alive) {
+            jobs.push_back(TuningJob{candidates[index], length});
+        }
+        std::vector<double> round;
+        if (!run_jobs(jobs, trace, workers, round)) {
+            return false;
+        }
+        for (size_t i = 0; i < alive.size(); i++) {
+            scores[alive[i]] = round[i];
+        }
+        result.simulated_accesses += length * alive.size();
+    
+        std::sort(alive.begin(), alive.end(),
+                  [&scores](size_t a, size_t b) { return scores[a] < scores[b]; });
+        std::cout << "[Autotune] " << workload << ": " << jobs.size() << " configurations on "
+                  << length << " accesses, best AMAT " << std::fixed << std::setprecision(3)
+                  << scores[alive[0]] << std::endl;
+        if (length >= trace.size()) {
+            break;
+        }
+    
+        // Keep the defaults alive to the last round as the reference
+        size_t keep = std::max<size_t>(1, alive.size() / AUTOTUNE_ETA);
+        size_t default_index = candidates.size() - 1;
+        bool default_kept = std::find(alive.begin(), alive.begin() + keep, default_index) !=
+                            alive.begin() + keep;
+        alive.resize(keep);
+        if (!default_kept) {
+            alive.push_back(default_index);
+        }
+        length = std::min<uint64_t>(length * AUTOTUNE_ETA, trace.size());
+    }
+    
+    result.best_config = candidates[alive[0]];
+    result.best_amat = scores[alive[0]];
+    result.default_amat = scores[candidates.size() - 1];
+    
+    // One parameter at a time across its range, the others held at the best
+    Candidate best_values = config_values(result.best_config);
+    std::vector<TuningJob> jobs;
+    std::vector<size_t> job_param;
+    for (size_t p = 0; p < NUM_TUNABLE_PARAMS; p++) {
+        const TunableParam& param = TUNABLE_PARAMS[p];
+        for (uint32_t k = 0; k < AUTOTUNE_SENSITIVITY_POINTS; k++) {
+            Candidate values = best_values;
+            values[p] = param.min_value + (param.max_value - param.min_value) * k /
+                        (AUTOTUNE_SENSITIVITY_POINTS - 1);
+            SimConfig config;
+            if (build_config(base, values, config)) {
+                jobs.push_back(TuningJob{config, trace.size()});
+                job_param.push_back(p);
+            }
+        }
+    }
+    std::vector<double> sweep;
+    if (!run_jobs(jobs, trace, workers, sweep)) {
+        return false;
+    }
+    result.simulated_accesses += jobs.size() * trace.size();
+    
+    result.sensitivity_low.assign(NUM_TUNABLE_PARAMS, result.best_amat);
+    result.sensitivity_high.assign(NUM_TUNABLE_PARAMS, result.best_amat);
+    for (size_t j = 0; j < jobs.size(); j++) {
+        size_t p = job_param[j];
+        result.sensitivity_low[p] = std::min(result.sensitivity_low[p], sweep[j]);
+        result.sensitivity_high[p] = std::max(result.sensitivity_high[p], sweep[j]);
+    }
+    return true;
+}
+
+static void write_report(const std::vector<TuningResult>& results, uint32_t num_candidates,
+                         uint64_t seed) {
+    std::ostringstream report;
+    report << "Autotuner Report\n";
+    report << "================\n";
+    report << num_candidates << " random configurations per workload (seed " << seed
+           << "), successive halving by " << AUTOTUNE_ETA << " from 1/"
+           << AUTOTUNE_MIN_PREFIX_FRACTION << " of the trace; objective: adaptive AMAT\n\n";
+    
+    for (const TuningResult& result : results) {
+        report << "--- " << result.workload << " ---\n";
+        report << std::fixed << std::setprecision(3);
+        report << "Default AMAT: " << result.default_amat << " cycles\n";
+        report << "Tuned AMAT:   " << result.best_amat << " cycles ("
+               << std::setprecision(2)
+               << (result.default_amat > 0 ? (result.default_amat - result.best_amat) /
+                                             result.default_amat * 100 : 0.0)
+               << "% lower)\n";
+        report << "Simulated accesses: " << result.simulated_accesses << "\n";
+        report << "Best configuration: results/autotune_" << result.workload << ".cfg\n\n";
+    
+        // Parameters ordered by how far the AMAT moves across their range
+        std::vector<size_t> order(NUM_TUNABLE_PARAMS);
+        for (size_t p = 0; p < order.size(); p++) {
+            order[p] = p;
+        }
+        std::sort(order.begin(), order.end(), [&result](size_t a, size_t b) {
+            return result.sensitivity_high[a] - result.sensitivity_low[a] >
+                   result.sensitivity_high[b] - result.sensitivity_low[b];
+        });
+        Candidate best_values = config_values(result.best_config);
+        report << std::setw(28) << std::left << "Parameter" << std::right
+               << std::setw(10) << "Best" << std::setw(12) << "Min AMAT"
+               << std::setw(12) << "Max AMAT" << std::setw(10) << "Spread" << "\n";
+        report << std::string(72, '-') << "\n";
+        for (size_t p : order) {
+            report << std::setw(28) << std::left << TUNABLE_PARAMS[p].key << std::right
+                   << std::setw(10) << format_value(TUNABLE_PARAMS[p], best_values[p])
+                   << std::setprecision(3)
+                   << std::setw(12) << result.sensitivity_low[p]
+                   << std::setw(12) << result.sensitivity_high[p]
+                   << std::setw(10) << (result.sensitivity_high[p] - result.sensitivity_low[p]) << "\n";
+        }
+        report << "\n";
+    }
+    
+    std::ofstream out("results/AUTOTUNE_REPORT.txt");
+    out << report.str();
+    std::cout << "\n" << report.str();
+    std::cout << "Autotuner report saved to: results/AUTOTUNE_REPORT.txt" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t num_candidates = AUTOTUNE_CANDIDATES;
+    uint64_t trace_length = AUTOTUNE_TRACE_LENGTH;
+    uint64_t seed = 1;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t workers = cpus > 0 ? cpus : 1;
+    std::string only_workload;
+    SimConfig base;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--candidates" && i + 1 < argc && parse_number(argv[i + 1], num_candidates)) {
+            i++;
+        } else if (arg == "--length" && i + 1 < argc && parse_number(argv[i + 1], trace_length) && trace_length > 0) {
+            i++;
+        } else if (arg == "--jobs" && i + 1 < argc && parse_number(argv[i + 1], workers) && workers > 0) {
+            i++;
+        } else if (arg == "--seed" && i + 1 < argc && parse_number(argv[i + 1], seed)) {
+            i++;
+        } else if (arg == "--workload" && i + 1 < argc) {
+            only_workload = argv[++i];
+        } else if (arg == "--config" && i + 1 < argc) {
+            if (!base.load_file(argv[++i])) {
+                return 1;
+            }
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--candidates <n>] [--length <accesses>]"
+                      << " [--jobs <n>] [--seed <n>] [--workload <name>] [--config <file>]" << std::endl;
+            return 1;
+        }
+    }
+    
+    struct Workload {
+        const char* name;
+        std::vector<uint64_t> (*generate)(uint64_t, uint32_t);
+    };
+    const Workload workloads[] = {
+        {"memory_intensive", WorkloadGenerator::generate_memory_intensive},
+        {"compute_intensive", WorkloadGenerator::generate_compute_intensive},
+        {"mixed", WorkloadGenerator::generate_mixed},
+        {"random_access", WorkloadGenerator::generate_random_access},
+    };
+    
+    std::cout << "============================================================" << std::endl;
+    std::cout << "   Adaptive Controller Autotuner (" << workers << " workers)" << std::endl;
+    std::cout << "============================================================" << std::endl;
+    
+    std::mt19937_64 rng(seed);
+    std::vector<TuningResult> results;
+    for (const Workload& workload : workloads) {
+        if (!only_workload.empty() && only_workload != workload.name) {
+            continue;
+        }
+        std::vector<uint64_t> trace = workload.generate(trace_length, (uint32_t)seed);
+        TuningResult result;
+        if (!tune_workload(workload.name, trace, base, num_candidates, workers, rng, result)) {
+            std::cerr << "[Autotune] Tuning " << workload.name << " lost jobs; no configuration written" << std::endl;
+            return 1;
+        }
+        results.push_back(result);
+    
+        std::string path = std::string("results/autotune_") + workload.name + ".cfg";
+        std::ofstream cfg(path);
+        cfg << "# Tuned for " << workload.name << " by simulations/autotune (seed " << seed << ")\n";
+        results.back().best_config.write(cfg);
+    }
+    if (results.empty()) {
+        std::cerr << "[Autotune] Unknown workload: " << only_workload << std::endl;
+        return 1;
+    }
+    
+    write_report(results, num_candidates, seed);
+    return 0;
+}
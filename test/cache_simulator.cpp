@@ -2,12 +2,15 @@
 #include "../src/cache/victim_cache.h"
 #include "../src/monitoring/phase_detector.h"
 #include "../src/adaptive/adaptive_controller.h"
+#include "../src/monitoring/profiler.h"
+#include "../src/monitoring/interval_sink.h"
 #include <iostream>
 #include <iomanip>
 #include <fstream>
 #include <cstdlib>
 #include <ctime>
 #include <cmath>
+#include <algorithm>
 
 SetAssociativeCache::SetAssociativeCache(std::string cache_name, uint32_t size, uint32_t assoc)
     : num_sets(size / assoc), associativity(assoc), global_lru(0), name(cache_name) {
@@ -17,16 +20,19 @@ SetAssociativeCache::SetAssociativeCache(std::string cache_name, uint32_t size,
     }
 }
 
-uint32_t SetAssociativeCache::get_set_index(uint64_t address) {
+uint32_t SetAssociativeCache::get_set_index(uint64_t address) const {
     return (address / BLOCK_SIZE) % num_sets;
 }
 
-int SetAssociativeCache::find_way(uint32_t set, uint64_t tag) {
+int SetAssociativeCache::find_way(uint32_t set, uint64_t tag) const {
+    VC_PROFILE_SCOPE(PROF_FIND_WAY);
     for (uint32_t i = 0; i < associativity; i++) {
         if (sets[set][i].valid && sets[set][i].tag == tag) {
+            VC_PROFILE_COUNT(PROF_CACHE_WAYS_SCANNED, i + 1);
             return i;
         }
     }
+    VC_PROFILE_COUNT(PROF_CACHE_WAYS_SCANNED, associativity);
     return -1;
 }
 
@@ -46,7 +52,29 @@ uint32_t SetAssociativeCache::find_lru_way(uint32_t set) {
     return lru_way;
 }
 
-bool SetAssociativeCache::access(uint64_t address, uint64_t* evicted_address, uint32_t* evicted_access_count) {
+void SetAssociativeCache::evict_for_fill(uint32_t set, uint32_t way, EvictedBlock* evicted) {
+    CacheBlock& block = sets[set][way];
+    if (!block.valid) {
+        return;
+    }
+    
+    stats.evictions++;
+    if (block.prefetched) {
+        stats.unused_prefetch_evictions++;
+    }
+    if (block.dirty) {
+        stats.dirty_evictions++;
+    }
+    if (evicted) {
+        evicted->valid = true;
+        evicted->address = block.tag * BLOCK_SIZE;
+        evicted->access_count = block.access_count;
+        evicted->dirty = block.dirty;
+    }
+}
+
+bool SetAssociativeCache::access(uint64_t address, bool is_write, EvictedBlock* evicted,
+                                 uint64_t* prefetch_ready) {
     stats.accesses++;
     
     uint32_t set = get_set_index(address);
@@ -57,45 +85,159 @@ bool SetAssociativeCache::access(uint64_t address, uint64_t* evicted_address, ui
         stats.hits++;
         sets[set][way].lru_counter = global_lru++;
         sets[set][way].access_count++;
+        sets[set][way].dirty = sets[set][way].dirty || is_write;
+        if (sets[set][way].prefetched) {
+            sets[set][way].prefetched = false;
+            if (prefetch_ready) {
+                *prefetch_ready = sets[set][way].ready_cycle;
+            }
+        }
         return true;
     }
     
     stats.misses++;
     
     uint32_t victim_way = find_lru_way(set);
+    evict_for_fill(set, victim_way, evicted);
     
-    if (sets[set][victim_way].valid) {
-        stats.evictions++;
-        if (evicted_address) {
-            *evicted_address = sets[set][victim_way].tag * BLOCK_SIZE;
-        }
-        if (evicted_access_count) {
-            *evicted_access_count = sets[set][victim_way].access_count;
+    sets[set][victim_way].tag = tag;
+    sets[set][victim_way].valid = true;
+    sets[set][victim_way].lru_counter = global_lru++;
+    sets[set][victim_way].access_count = 0;
+    sets[set][victim_way].prefetched = false;
+    sets[set][victim_way].dirty = is_write;
+    
+    return false;
+}
+
+bool SetAssociativeCache::probe(uint64_t address, uint64_t* prefetch_ready) {
+    stats.accesses++;
+    
+    uint32_t set = get_set_index(address);
+    int way = find_way(set, address / BLOCK_SIZE);
+    if (way < 0) {
+        stats.misses++;
+        return false;
+    }
+    
+    stats.hits++;
+    sets[set][way].lru_counter = global_lru++;
+    sets[set][way].access_count++;
+    if (sets[set][way].prefetched) {
+        sets[set][way].prefetched = false;
+        if (prefetch_ready) {
+            *prefetch_ready = sets[set][way].ready_cycle;
         }
     }
+    return true;
+}
+
+// Installs a clean block without counting an access (inclusive fills,
+// exclusive spills)
+void SetAssociativeCache::insert(uint64_t address, EvictedBlock* evicted) {
+    uint32_t set = get_set_index(address);
+    uint64_t tag = address / BLOCK_SIZE;
+    
+    int way = find_way(set, tag);
+    if (way >= 0) {
+        sets[set][way].lru_counter = global_lru++;
+        return;
+    }
+    
+    uint32_t victim_way = find_lru_way(set);
+    evict_for_fill(set, victim_way, evicted);
     
     sets[set][victim_way].tag = tag;
     sets[set][victim_way].valid = true;
     sets[set][victim_way].lru_counter = global_lru++;
     sets[set][victim_way].access_count = 0;
-    
-    return false;
+    sets[set][victim_way].prefetched = false;
+    sets[set][victim_way].dirty = false;
 }
 
-void SetAssociativeCache::insert(uint64_t address) {
+bool SetAssociativeCache::prefetch_fill(uint64_t address, uint64_t ready_cycle, EvictedBlock* evicted) {
     uint32_t set = get_set_index(address);
     uint64_t tag = address / BLOCK_SIZE;
     
+    if (find_way(set, tag) >= 0) {
+        return false;
+    }
+    
     uint32_t victim_way = find_lru_way(set);
+    evict_for_fill(set, victim_way, evicted);
+    
+    stats.prefetch_fills++;
+    sets[set][victim_way].tag = tag;
+    sets[set][victim_way].valid = true;
+    sets[set][victim_way].lru_counter = global_lru++;
+    sets[set][victim_way].access_count = 0;
+    sets[set][victim_way].prefetched = true;
+    sets[set][victim_way].ready_cycle = ready_cycle;
+    sets[set][victim_way].dirty = false;
+    return true;
+}
+
+// Accepts a dirty block from the level above. Write-allocate: a block that is
+// no longer resident is installed dirty, possibly displacing another one.
+void SetAssociativeCache::write_back(uint64_t address, EvictedBlock* evicted) {
+    uint32_t set = get_set_index(address);
+    uint64_t tag = address / BLOCK_SIZE;
+    stats.writebacks_received++;
     
-    if (sets[set][victim_way].valid) {
-        stats.evictions++;
+    int way = find_way(set, tag);
+    if (way >= 0) {
+        sets[set][way].dirty = true;
+        return;
     }
     
+    uint32_t victim_way = find_lru_way(set);
+    evict_for_fill(set, victim_way, evicted);
+    
     sets[set][victim_way].tag = tag;
     sets[set][victim_way].valid = true;
     sets[set][victim_way].lru_counter = global_lru++;
     sets[set][victim_way].access_count = 0;
+    sets[set][victim_way].prefetched = false;
+    sets[set][victim_way].dirty = true;
+}
+
+void SetAssociativeCache::mark_dirty(uint64_t address) {
+    uint32_t set = get_set_index(address);
+    int way = find_way(set, address / BLOCK_SIZE);
+    if (way >= 0) {
+        sets[set][way].dirty = true;
+    }
+}
+
+bool SetAssociativeCache::invalidate(uint64_t address, bool* was_dirty) {
+    uint32_t set = get_set_index(address);
+    int way = find_way(set, address / BLOCK_SIZE);
+    if (way < 0) {
+        return false;
+    }
+    
+    if (was_dirty) {
+        *was_dirty = sets[set][way].dirty;
+    }
+    sets[set][way].valid = false;
+    sets[set][way].prefetched = false;
+    sets[set][way].dirty = false;
+    return true;
+}
+
+bool SetAssociativeCache::contains(uint64_t address) const {
+    return find_way(get_set_index(address), address / BLOCK_SIZE) >= 0;
+}
+
+void SetAssociativeCache::get_resident_addresses(std::vector<uint64_t>& out) const {
+    out.clear();
+    for (const auto& set : sets) {
+        for (const auto& block : set) {
+            if (block.valid) {
+                out.push_back(block.tag * BLOCK_SIZE);
+            }
+        }
+    }
 }
 
 void SetAssociativeCache::print_stats() const {
@@ -106,15 +248,27 @@ void SetAssociativeCache::print_stats() const {
     std::cout << "  Hit Rate: " << std::fixed << std::setprecision(2) 
               << (stats.get_hit_rate() * 100) << "%" << std::endl;
     std::cout << "  Miss Rate: " << (stats.get_miss_rate() * 100) << "%" << std::endl;
+    std::cout << "  Dirty Evictions: " << stats.dirty_evictions << std::endl;
+    std::cout << "  Write-backs Received: " << stats.writebacks_received << std::endl;
+    if (stats.prefetch_fills > 0) {
+        std::cout << "  Prefetch Fills: " << stats.prefetch_fills << std::endl;
+        std::cout << "  Unused Prefetches Evicted: " << stats.unused_prefetch_evictions << std::endl;
+    }
 }
 
 void SetAssociativeCache::reset_stats() {
     stats = CacheStats();
 }
 
-CacheHierarchySimulator::CacheHierarchySimulator(bool enable_victim, bool enable_adaptive)
-    : use_victim_cache(enable_victim), use_adaptive(enable_adaptive), total_instructions(0),
-      instructions_since_last_adapt(0), adaptation_interval(5000) {
+CacheHierarchySimulator::CacheHierarchySimulator(bool enable_victim, bool enable_adaptive,
+                                                 const SimConfig& config)
+    : use_victim_cache(enable_victim), use_adaptive(enable_adaptive),
+      configured_victim_size(enable_adaptive ? config.adaptive_start_size : config.static_victim_size),
+      total_instructions(0),
+      instructions_since_last_adapt(0), adaptation_interval(config.check_interval), prefetcher(nullptr),
+      prefetch_level(PREFETCH_AT_L1), prefetch_into_victim(false),
+      inclusion(INCLUSION_NON_INCLUSIVE), swap_on_victim_hit(false),
+      interval_sink(nullptr), sink_interval(0), sink_interval_start(0), intervals_emitted(0), sink_adaptations(0) {
     
     l1_cache = new SetAssociativeCache("L1 Cache", L1_SIZE, L1_ASSOCIATIVITY);
     l2_cache = new SetAssociativeCache("L2 Cache", L2_SIZE, L2_ASSOCIATIVITY);
@@ -124,16 +278,20 @@ CacheHierarchySimulator::CacheHierarchySimulator(bool enable_victim, bool enable
     
     if (use_victim_cache) {
         if (use_adaptive) {
-            victim_cache = new VictimCache(80);
-            phase_detector = new PhaseDetector();
+            victim_cache = new VictimCache(config.adaptive_start_size, config);
+            phase_detector = new PhaseDetector(config);
             adaptive_controller = new AdaptiveController(
                 static_cast<VictimCache*>(victim_cache),
-                static_cast<PhaseDetector*>(phase_detector)
+                static_cast<PhaseDetector*>(phase_detector),
+                config
             );
-            std::cout << "[Simulator] Using ADAPTIVE victim cache (64-256 entries, starts at 80) with SMART INSERTION + AGGRESSIVE GROWTH" << std::endl;
+            std::cout << "[Simulator] Using ADAPTIVE victim cache (" << MIN_VICTIM_SIZE << "-" << MAX_VICTIM_SIZE
+                      << " entries, starts at " << config.adaptive_start_size
+                      << ") with SMART INSERTION + AGGRESSIVE GROWTH" << std::endl;
         } else {
-            victim_cache = new VictimCache(128);
-            std::cout << "[Simulator] Using STATIC victim cache (128 entries FIXED) with SMART INSERTION" << std::endl;
+            victim_cache = new VictimCache(config.static_victim_size, config);
+            std::cout << "[Simulator] Using STATIC victim cache (" << config.static_victim_size
+                      << " entries FIXED) with SMART INSERTION" << std::endl;
         }
     } else {
         victim_cache = nullptr;
@@ -153,45 +311,539 @@ CacheHierarchySimulator::~CacheHierarchySimulator() {
     if (phase_detector) {
         delete static_cast<PhaseDetector*>(phase_detector);
     }
+    delete prefetcher;
 }
 
-void CacheHierarchySimulator::access_memory(uint64_t address) {
-    uint64_t evicted_address = 0;
-    uint32_t evicted_access_count = 0;
+void CacheHierarchySimulator::attach_prefetcher(PrefetcherType type, PrefetchLevel level, bool into_victim) {
+    delete prefetcher;
+    prefetcher = Prefetcher::create(type);
+    prefetch_level = level;
+    prefetch_into_victim = into_victim && use_victim_cache;
     
-    bool l1_hit = l1_cache->access(address, &evicted_address, &evicted_access_count);
+    if (prefetcher) {
+        std::cout << "[Simulator] " << prefetcher->get_name() << " prefetcher attached to "
+                  << (level == PREFETCH_AT_L1 ? "L1" : "L2")
+                  << (prefetch_into_victim ? " (filling the victim cache as a prefetch buffer)" : "")
+                  << std::endl;
+    }
+}
+
+void CacheHierarchySimulator::set_timing_config(const TimingConfig& config) {
+    timing = config;
+    // A victim hit that turns into a miss costs the L2 access behind it
+    if (adaptive_controller) {
+        static_cast<AdaptiveController*>(adaptive_controller)->set_miss_penalty(timing.l2_hit_latency);
+    }
+}
+
+void CacheHierarchySimulator::set_inclusion_policy(InclusionPolicy policy) {
+    inclusion = policy;
+    // Under exclusion clean victim-cache evictions are the only way into L2
+    if (use_victim_cache && victim_cache) {
+        static_cast<VictimCache*>(victim_cache)->set_spill_clean_blocks(policy == INCLUSION_EXCLUSIVE);
+    }
+}
+
+void CacheHierarchySimulator::set_phase_prediction(bool enable) {
+    if (adaptive_controller) {
+        static_cast<AdaptiveController*>(adaptive_controller)->set_proactive(enable);
+    }
+}
+
+bool CacheHierarchySimulator::set_adaptation_policy(const std::string& name) {
+    AdaptationPolicy policy;
+    if (!AdaptiveController::parse_policy(name, policy)) {
+        return false;
+    }
+    if (adaptive_controller) {
+        static_cast<AdaptiveController*>(adaptive_controller)->set_policy(policy);
+    }
+    return true;
+}
+
+bool CacheHierarchySimulator::is_adaptation_policy(const std::string& name) {
+    AdaptationPolicy policy;
+    return AdaptiveController::parse_policy(name, policy);
+}
+
+void CacheHierarchySimulator::set_entry_cost(double cost) {
+    if (adaptive_controller) {
+        static_cast<AdaptiveController*>(adaptive_controller)->set_entry_cost(cost);
+    }
+}
+
+bool CacheHierarchySimulator::set_control_setpoint(const std::string& metric, double value) {
+    ControlTarget target;
+    if (metric == "hit-rate") {
+        target = TARGET_HIT_RATE;
+    } else if (metric == "occupancy") {
+        target = TARGET_OCCUPANCY;
+    } else {
+        return false;
+    }
     
-    if (l1_hit) {
+    if (value < 0.0) {
+        value = (target == TARGET_OCCUPANCY) ? PID_OCCUPANCY_SETPOINT : PID_HIT_RATE_SETPOINT;
+    }
+    if (adaptive_controller) {
+        static_cast<AdaptiveController*>(adaptive_controller)->set_setpoint(target, value);
+    }
+    return true;
+}
+
+bool CacheHierarchySimulator::set_objective(const std::string& name) {
+    AdaptationObjective objective;
+    if (!AdaptiveController::parse_objective(name, objective)) {
+        return false;
+    }
+    if (adaptive_controller) {
+        static_cast<AdaptiveController*>(adaptive_controller)->set_objective(objective);
+    }
+    return true;
+}
+
+void CacheHierarchySimulator::set_power_gating(bool enable) {
+    if (victim_cache) {
+        static_cast<VictimCache*>(victim_cache)->set_power_gating(enable);
+    }
+}
+
+void CacheHierarchySimulator::set_bypass_dueling(bool enable) {
+    if (victim_cache) {
+        static_cast<VictimCache*>(victim_cache)->set_bypass_dueling(enable);
+    }
+}
+
+EnergyStats CacheHierarchySimulator::get_victim_energy() const {
+    if (!victim_cache) {
+        return EnergyStats();
+    }
+    return static_cast<const VictimCache*>(victim_cache)->get_energy_stats();
+}
+
+PredictionStats CacheHierarchySimulator::get_prediction_stats() const {
+    if (!phase_detector) {
+        return PredictionStats();
+    }
+    return static_cast<const PhaseDetector*>(phase_detector)->get_predictor().get_stats();
+}
+
+const char* CacheHierarchySimulator::inclusion_policy_name(InclusionPolicy policy) {
+    switch (policy) {
+        case INCLUSION_INCLUSIVE: return "INCLUSIVE";
+        case INCLUSION_EXCLUSIVE: return "EXCLUSIVE";
+        case INCLUSION_NON_INCLUSIVE:
+        default:
+            return "NON-INCLUSIVE";
+    }
+}
+
+bool CacheHierarchySimulator::parse_inclusion_policy(const std::string& name, InclusionPolicy& policy) {
+    if (name == "non-inclusive" || name == "nine") {
+        policy = INCLUSION_NON_INCLUSIVE;
+    } else if (name == "inclusive") {
+        policy = INCLUSION_INCLUSIVE;
+    } else if (name == "exclusive") {
+        policy = INCLUSION_EXCLUSIVE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+uint64_t CacheHierarchySimulator::wait_for_prefetch(uint64_t ready_cycle, uint64_t elapsed) {
+    if (ready_cycle == 0 || !prefetcher) {
+        return 0;
+    }
+    
+    PrefetchStats& ps = prefetcher->get_stats();
+    ps.useful++;
+    
+    uint64_t arrival = timing_stats.total_cycles + elapsed;
+    if (ready_cycle > arrival) {
+        ps.late++;
+        ps.late_cycles += ready_cycle - arrival;
+        return ready_cycle - arrival;
+    }
+    return 0;
+}
+
+void CacheHierarchySimulator::count_uncovered_miss(PrefetchLevel level) {
+    if (prefetcher && prefetch_level == level) {
+        prefetcher->get_stats().uncovered_misses++;
+    }
+}
+
+void CacheHierarchySimulator::train_prefetcher(PrefetchLevel level, uint64_t address, bool miss) {
+    if (!prefetcher || prefetch_level != level) {
+        return;
+    }
+    
+    prefetch_candidates.clear();
+    prefetcher->observe(address, miss, prefetch_candidates);
+    for (uint64_t candidate : prefetch_candidates) {
+        issue_prefetch(candidate);
+    }
+}
+
+void CacheHierarchySimulator::issue_prefetch(uint64_t address) {
+    PrefetchStats& ps = prefetcher->get_stats();
+    VictimCache* vc = static_cast<VictimCache*>(victim_cache);
+    
+    SetAssociativeCache* target = (prefetch_level == PREFETCH_AT_L1) ? l1_cache : l2_cache;
+    if (target->contains(address) || (prefetch_into_victim && vc->contains(address)) ||
+        (inclusion == INCLUSION_EXCLUSIVE && target == l2_cache && l1_cache->contains(address))) {
+        ps.filtered++;
+        return;
+    }
+    
+    bool l2_resident = l2_cache->contains(address);
+    bool from_l2 = (prefetch_level == PREFETCH_AT_L1) && l2_resident;
+    if (!from_l2) {
+        ps.memory_fetches++;
+        traffic.l2_memory.fill_bytes += BLOCK_SIZE;
+    }
+    if (prefetch_level == PREFETCH_AT_L1) {
+        traffic.upper_l2.fill_bytes += BLOCK_SIZE;
+    }
+    ps.issued++;
+    
+    // A block prefetched above L2 must also land in an inclusive L2, and must
+    // leave an exclusive one
+    bool fills_l2 = (prefetch_level == PREFETCH_AT_L2) && !prefetch_into_victim;
+    if (!fills_l2 && inclusion == INCLUSION_INCLUSIVE && !l2_resident) {
+        EvictedBlock l2_evicted;
+        l2_cache->insert(address, &l2_evicted);
+        handle_l2_eviction(l2_evicted);
+    } else if (!fills_l2 && inclusion == INCLUSION_EXCLUSIVE && l2_resident) {
+        bool l2_dirty = false;
+        l2_cache->invalidate(address, &l2_dirty);
+        residency.exclusive_moves++;
+        if (l2_dirty) {
+            traffic.l2_memory.writeback_bytes += BLOCK_SIZE;
+        }
+    }
+    
+    if (prefetch_into_victim) {
+        vc->insert_prefetch(address);
+        drain_victim_spills();
+        return;
+    }
+    
+    uint64_t ready = timing_stats.total_cycles + 
+                     (from_l2 ? timing.l2_hit_latency : timing.memory_latency);
+    EvictedBlock evicted;
+    target->prefetch_fill(address, ready, &evicted);
+    
+    // Blocks displaced from L1 by a prefetch still go to the victim cache,
+    // which is where prefetch pollution gets absorbed
+    if (target == l1_cache) {
+        spill_l1_eviction(evicted);
+    } else {
+        handle_l2_eviction(evicted);
+    }
+}
+
+// Dirty blocks are written back; clean ones only arrive here under exclusion
+void CacheHierarchySimulator::spill_to_l2(uint64_t address, bool dirty) {
+    traffic.upper_l2.writeback_bytes += BLOCK_SIZE;
+    
+    EvictedBlock evicted;
+    if (dirty) {
+        l2_cache->write_back(address, &evicted);
+    } else {
+        l2_cache->insert(address, &evicted);
+    }
+    handle_l2_eviction(evicted);
+}
+
+void CacheHierarchySimulator::handle_l2_eviction(const EvictedBlock& evicted) {
+    if (!evicted.valid) {
+        return;
+    }
+    
+    bool dirty = evicted.dirty;
+    if (inclusion == INCLUSION_INCLUSIVE) {
+        bool upper_dirty = false;
+        bool found = l1_cache->invalidate(evicted.address, &upper_dirty);
+        dirty = dirty || upper_dirty;
+        
+        if (use_victim_cache && victim_cache) {
+            upper_dirty = false;
+            found = static_cast<VictimCache*>(victim_cache)->invalidate(evicted.address, &upper_dirty) || found;
+            dirty = dirty || upper_dirty;
+        }
+        if (found) {
+            residency.back_invalidations++;
+        }
+    }
+    
+    if (dirty) {
+        traffic.l2_memory.writeback_bytes += BLOCK_SIZE;
+    }
+}
+
+void CacheHierarchySimulator::drain_victim_spills() {
+    if (!use_victim_cache || !victim_cache) {
+        return;
+    }
+    
+    VictimCache* vc = static_cast<VictimCache*>(victim_cache);
+    if (!vc->has_pending_spills()) {
+        return;
+    }
+    
+    vc->take_spills(victim_spills);
+    for (const VictimSpill& spill : victim_spills) {
+        spill_to_l2(spill.address, spill.dirty);
+    }
+}
+
+// L1 evictions go to the victim cache when there is one; otherwise dirty
+// blocks (and, under exclusion, clean ones too) travel on to L2
+void CacheHierarchySimulator::spill_l1_eviction(const EvictedBlock& evicted) {
+    if (!evicted.valid) {
         return;
     }
     
     if (use_victim_cache && victim_cache) {
         VictimCache* vc = static_cast<VictimCache*>(victim_cache);
-        
-        if (evicted_address != 0) {
-            vc->insert_smart(evicted_address, evicted_address >> 6, nullptr, evicted_access_count);
+        if (vc->insert_smart(evicted.address, evicted.address >> 6, nullptr, 
+                             evicted.access_count, evicted.dirty)) {
+            traffic.l1_victim.writeback_bytes += BLOCK_SIZE;
         }
+        drain_victim_spills();
+    } else if (evicted.dirty || inclusion == INCLUSION_EXCLUSIVE) {
+        spill_to_l2(evicted.address, evicted.dirty);
+    }
+}
+
+void CacheHierarchySimulator::account_latency(uint64_t cycles) {
+    timing_stats.accesses++;
+    timing_stats.total_cycles += cycles;
+    timing_stats.stall_cycles += cycles - timing.l1_hit_latency;
+    if (victim_cache) {
+        static_cast<VictimCache*>(victim_cache)->advance_cycles(cycles);
+    }
+}
+
+void CacheHierarchySimulator::access_memory(uint64_t address, AccessType type) {
+    VC_PROFILE_SCOPE(PROF_ACCESS_MEMORY);
+    bool is_write = (type == ACCESS_WRITE);
+    EvictedBlock evicted;
+    uint64_t prefetch_ready = 0;
+    uint64_t latency = timing.l1_hit_latency;
+    
+    bool l1_hit = l1_cache->access(address, is_write, &evicted, &prefetch_ready);
+    latency += wait_for_prefetch(prefetch_ready, 0);
+    
+    if (phase_detector) {
+        static_cast<PhaseDetector*>(phase_detector)->record_memory_access(address, !l1_hit);
+    }
+    
+    if (l1_hit) {
+        train_prefetcher(PREFETCH_AT_L1, address, prefetch_ready != 0);
+        account_latency(latency);
+        return;
+    }
+    
+    uint32_t victim_latency = 0;
+    VictimCache* vc = (use_victim_cache && victim_cache) ? static_cast<VictimCache*>(victim_cache) : nullptr;
+    
+    // With swap-on-hit the victim cache is probed before the L1 victim is
+    // spilled, so a hit can hand its entry straight to the displaced block
+    bool swap = vc && swaps_on_victim_hit();
+    if (!swap) {
+        spill_l1_eviction(evicted);
+    }
+    
+    if (vc) {
+        victim_latency = timing.victim_latency(vc->get_current_size());
         
-        if (vc->lookup(address)) {
+        bool victim_prefetch_hit = false;
+        bool victim_dirty = false;
+        if (vc->lookup(address, &victim_prefetch_hit, &victim_dirty)) {
+            latency += victim_latency;
+            timing_stats.victim_hit_savings += (int64_t)timing.l2_hit_latency - victim_latency;
+            traffic.l1_victim.fill_bytes += BLOCK_SIZE;
+            if (victim_dirty) {
+                l1_cache->mark_dirty(address);
+            }
+            if (swap) {
+                vc->swap(address, evicted.valid ? evicted.address : address,
+                         evicted.dirty, evicted.access_count);
+                if (evicted.valid) {
+                    traffic.l1_victim.writeback_bytes += BLOCK_SIZE;
+                }
+            } else {
+                residency.duplicate_fills++;
+            }
+            if (victim_prefetch_hit && prefetcher) {
+                prefetcher->get_stats().useful++;
+            } else {
+                count_uncovered_miss(PREFETCH_AT_L1);
+            }
+            train_prefetcher(PREFETCH_AT_L1, address, true);
+            account_latency(latency);
             return;
         }
+        if (swap) {
+            spill_l1_eviction(evicted);
+        }
     }
+    count_uncovered_miss(PREFETCH_AT_L1);
     
-    bool l2_hit = l2_cache->access(address);
+    prefetch_ready = 0;
+    bool l2_hit;
+    if (inclusion == INCLUSION_EXCLUSIVE) {
+        // The block moves up instead of being copied, and a memory fill
+        // bypasses L2 entirely
+        l2_hit = l2_cache->probe(address, &prefetch_ready);
+        if (l2_hit) {
+            bool l2_dirty = false;
+            l2_cache->invalidate(address, &l2_dirty);
+            residency.exclusive_moves++;
+            if (l2_dirty) {
+                l1_cache->mark_dirty(address);
+            }
+        }
+    } else {
+        EvictedBlock l2_evicted;
+        l2_hit = l2_cache->access(address, false, &l2_evicted, &prefetch_ready);
+        handle_l2_eviction(l2_evicted);
+    }
+    traffic.upper_l2.fill_bytes += BLOCK_SIZE;
+    
+    if (timing.probe_mode == VICTIM_PROBE_PARALLEL) {
+        uint32_t probe_latency = std::max(victim_latency, timing.l2_hit_latency);
+        latency += probe_latency;
+        timing_stats.victim_miss_overhead += probe_latency - timing.l2_hit_latency;
+    } else {
+        latency += victim_latency + timing.l2_hit_latency;
+        timing_stats.victim_miss_overhead += victim_latency;
+    }
+    latency += wait_for_prefetch(prefetch_ready, latency);
     
     if (!l2_hit) {
         memory_stats.accesses++;
         memory_stats.misses++;
+        traffic.l2_memory.fill_bytes += BLOCK_SIZE;
+        latency += timing.memory_latency;
+        count_uncovered_miss(PREFETCH_AT_L2);
     }
+    
+    train_prefetcher(PREFETCH_AT_L1, address, true);
+    train_prefetcher(PREFETCH_AT_L2, address, !l2_hit || prefetch_ready != 0);
+    account_latency(latency);
 }
 
 void CacheHierarchySimulator::simulate_instruction() {
     total_instructions++;
     instructions_since_last_adapt++;
+    if (phase_detector) {
+        static_cast<PhaseDetector*>(phase_detector)->record_instruction();
+    }
     
-    if (use_adaptive && instructions_since_last_adapt >= adaptation_interval) {
+    // A change point cuts the interval short so the controller reacts mid-window
+    if (use_adaptive && phase_detector &&
+        (instructions_since_last_adapt >= adaptation_interval ||
+         static_cast<PhaseDetector*>(phase_detector)->has_pending_change_point())) {
         check_adaptation();
     }
+    if (total_instructions % RESIDENCY_SAMPLE_INTERVAL == 0) {
+        sample_residency();
+    }
+    if (interval_sink && total_instructions % sink_interval == 0) {
+        emit_interval();
+    }
+}
+
+void CacheHierarchySimulator::attach_interval_sink(IntervalMetricsSink* sink, uint64_t interval) {
+    interval_sink = sink;
+    sink_interval = interval > 0 ? interval : std::max<uint64_t>(adaptation_interval, 1);
+    intervals_emitted = 0;
+    // Start the first interval here rather than at the start of the run
+    close_interval_counters();
+}
+
+void CacheHierarchySimulator::detach_interval_sink() {
+    if (!interval_sink) {
+        return;
+    }
+    if (total_instructions > sink_interval_start) {
+        emit_interval();
+    }
+    interval_sink = nullptr;
+}
+
+void CacheHierarchySimulator::close_interval_counters() {
+    const VictimStats* vs = victim_cache ? &static_cast<VictimCache*>(victim_cache)->get_stats() : nullptr;
+    interval_l1_accesses.close(l1_cache->get_stats().accesses);
+    interval_l1_hits.close(l1_cache->get_stats().hits);
+    interval_l2_accesses.close(l2_cache->get_stats().accesses);
+    interval_l2_hits.close(l2_cache->get_stats().hits);
+    interval_victim_lookups.close(vs ? vs->total_accesses : 0);
+    interval_victim_hits.close(vs ? vs->victim_hits : 0);
+    sink_adaptations = adaptive_controller ?
+        static_cast<const AdaptiveController*>(adaptive_controller)->get_adaptations() : 0;
+    sink_interval_start = total_instructions;
+}
+
+void CacheHierarchySimulator::emit_interval() {
+    uint64_t adaptations_before = sink_adaptations;
+    close_interval_counters();
+    
+    IntervalRecord record;
+    record.interval = intervals_emitted++;
+    record.instructions = total_instructions;
+    if (interval_l1_accesses.get() > 0) {
+        record.l1_hit_rate = (double)interval_l1_hits.get() / interval_l1_accesses.get();
+    }
+    if (interval_l2_accesses.get() > 0) {
+        record.l2_hit_rate = (double)interval_l2_hits.get() / interval_l2_accesses.get();
+    }
+    if (victim_cache) {
+        VictimCache* vc = static_cast<VictimCache*>(victim_cache);
+        record.victim_size = vc->get_current_size();
+        record.occupancy = vc->get_occupancy();
+        if (interval_victim_lookups.get() > 0) {
+            record.victim_hit_rate = (double)interval_victim_hits.get() / interval_victim_lookups.get();
+        }
+    }
+    if (phase_detector) {
+        const PhaseDetector* pd = static_cast<const PhaseDetector*>(phase_detector);
+        record.phase = pd->get_current_phase();
+        record.phase_id = pd->get_current_phase_id();
+    }
+    if (sink_adaptations != adaptations_before) {
+        const AdaptiveController* ac = static_cast<const AdaptiveController*>(adaptive_controller);
+        record.decision = ac->get_last_adaptation()->decision;
+    }
+    interval_sink->append(record);
+}
+
+// Counts blocks currently held by more than one level
+void CacheHierarchySimulator::sample_residency() {
+    residency.samples++;
+    
+    if (use_victim_cache && victim_cache) {
+        static_cast<VictimCache*>(victim_cache)->get_resident_addresses(residency_scratch);
+        for (uint64_t address : residency_scratch) {
+            if (l1_cache->contains(address)) {
+                residency.l1_victim_duplicates++;
+            }
+            if (l2_cache->contains(address)) {
+                residency.victim_l2_duplicates++;
+            }
+        }
+    }
+    
+    l1_cache->get_resident_addresses(residency_scratch);
+    for (uint64_t address : residency_scratch) {
+        if (l2_cache->contains(address)) {
+            residency.l1_l2_duplicates++;
+        }
+    }
 }
 
 void CacheHierarchySimulator::check_adaptation() {
@@ -199,46 +851,99 @@ void CacheHierarchySimulator::check_adaptation() {
         return;
     }
     
-    VictimCache* vc = static_cast<VictimCache*>(victim_cache);
     PhaseDetector* pd = static_cast<PhaseDetector*>(phase_detector);
     AdaptiveController* ac = static_cast<AdaptiveController*>(adaptive_controller);
     
-    uint64_t l1_misses = l1_cache->get_stats().misses;
-    uint64_t l1_accesses = l1_cache->get_stats().accesses;
-    pd->update(adaptation_interval, l1_accesses, l1_misses);
-    
-    VictimStats& stats = vc->get_stats();
-    stats.update_rates(vc->get_current_size());
-    stats.occupancy_rate = vc->get_occupancy();
+    // The detector is fed per access; it closes a window once it has seen
+    // a configured window of instructions
+    bool window_change = pd->check_phase_change();
+    bool change_point = pd->check_change_point();
+    if (window_change || change_point) {
+        ac->notify_phase_change();
+    }
     
-    ac->update(adaptation_interval);
+    ac->update(instructions_since_last_adapt);
+    drain_victim_spills();
     
     instructions_since_last_adapt = 0;
 }
 
+std::string CacheHierarchySimulator::describe_mode() const {
+    if (!use_victim_cache) {
+        return "BASELINE (No Victim Cache)";
+    }
+    if (use_adaptive) {
+        return "ADAPTIVE VICTIM CACHE (" + std::to_string(MIN_VICTIM_SIZE) + "-" + std::to_string(MAX_VICTIM_SIZE) +
+               " entries, starts at " + std::to_string(configured_victim_size) + ") with SMART INSERTION";
+    }
+    return "STATIC VICTIM CACHE (" + std::to_string(configured_victim_size) + " entries) with SMART INSERTION";
+}
+
 void CacheHierarchySimulator::print_summary() const {
+    std::cout << std::noshowpos;
     std::cout << "\n============================================================" << std::endl;
     std::cout << "           CACHE HIERARCHY SIMULATION RESULTS              " << std::endl;
     std::cout << "============================================================" << std::endl;
     
     std::cout << "\nConfiguration:" << std::endl;
-    if (!use_victim_cache) {
-        std::cout << "  Mode: BASELINE (No Victim Cache)" << std::endl;
-    } else if (use_adaptive) {
-        std::cout << "  Mode: ADAPTIVE VICTIM CACHE (64-256 entries) with SMART INSERTION" << std::endl;
-    } else {
-        std::cout << "  Mode: STATIC VICTIM CACHE (128 entries) with SMART INSERTION" << std::endl;
-    }
+    std::cout << "  Mode: " << describe_mode() << std::endl;
     
     l1_cache->print_stats();
     
     if (use_victim_cache && victim_cache) {
         VictimCache* vc = static_cast<VictimCache*>(victim_cache);
         vc->print_stats();
+        vc->get_energy_model().print_stats(vc->get_energy_stats());
+        std::cout << "  Powered Entries: " << vc->get_powered_entries()
+                  << (vc->is_power_gating() ? " (power gating)" : " (no power gating)") << std::endl;
+    }
+    
+    if (use_adaptive && phase_detector && adaptive_controller) {
+        const PhaseDetector* pd = static_cast<const PhaseDetector*>(phase_detector);
+        const AdaptiveController* ac = static_cast<const AdaptiveController*>(adaptive_controller);
+        std::cout << "\n=== Size Policy ===" << std::endl;
+        std::cout << "  Policy: " << AdaptiveController::policy_name(ac->get_policy());
+        if (ac->get_policy() == POLICY_MRC && ac->get_objective() == OBJECTIVE_EDP) {
+            std::cout << " (minimizing energy-delay product)";
+        } else if (ac->get_policy() == POLICY_MRC) {
+            std::cout << " (cost " << std::fixed << std::setprecision(4) << ac->get_entry_cost()
+                      << " hit rate per entry)";
+        } else if (ac->get_policy() == POLICY_PID) {
+            std::cout << " (" << (ac->get_control_target() == TARGET_OCCUPANCY ? "occupancy" : "hit rate")
+                      << " setpoint " << std::fixed << std::setprecision(2)
+                      << (ac->get_setpoint() * 100) << "%)";
+        }
+        std::cout << std::endl;
+        std::cout << "  Mean Size Move: " << std::fixed << std::setprecision(0)
+                  << ac->get_mean_move_time() << " instructions (" << ac->get_size_moves()
+                  << " completed moves)" << std::endl;
+        const VictimStats& vstats = static_cast<const VictimCache*>(victim_cache)->get_stats();
+        std::cout << "  Resize Oscillations: " << ac->get_oscillations() << std::endl;
+        std::cout << "  Churn Misses: " << vstats.churn_misses << " (of "
+                  << vstats.resize_flushes << " blocks flushed by shrinks)" << std::endl;
+        
+        std::cout << "\n=== Phase Detection ===" << std::endl;
+        std::cout << "  Working-Set Phase Changes: " << pd->get_phase_changes() << std::endl;
+        std::cout << "  Change Points (Page-Hinkley): " << pd->get_change_points() << std::endl;
+        std::cout << "  Phase-Triggered Adaptations: " << ac->get_phase_triggered_adaptations() << std::endl;
+        std::cout << "  Distinct Phases: " << pd->get_num_phase_ids() << std::endl;
+        std::cout << "  Memoized Restores: " << ac->get_memo_restores()
+                  << " (" << ac->get_intervals_saved() << " adaptation intervals saved)" << std::endl;
+        std::cout << "  Proactive Adaptations: " << ac->get_proactive_adaptations()
+                  << " (" << ac->get_proactive_confirmed() << " confirmed by the detector)" << std::endl;
+        pd->get_predictor().print_stats();
+        ac->print_phase_table();
+        if (ac->get_policy() == POLICY_BANDIT) {
+            ac->print_bandit_arms();
+        }
     }
     
     l2_cache->print_stats();
     
+    if (prefetcher) {
+        prefetcher->print_stats();
+    }
+    
     std::cout << "\n=== Memory Access Statistics ===" << std::endl;
     std::cout << "  Total Memory Accesses: " << memory_stats.accesses << std::endl;
     std::cout << "  Total Instructions: " << total_instructions << std::endl;
@@ -247,19 +952,50 @@ void CacheHierarchySimulator::print_summary() const {
         (double)memory_stats.accesses / (total_instructions / 1000.0) : 0.0;
     std::cout << "  MPKI (Misses per 1K Instructions): " << std::fixed 
               << std::setprecision(2) << mpki << std::endl;
+    
+    std::cout << "\n=== Traffic (bytes moved) ===" << std::endl;
+    if (use_victim_cache && victim_cache) {
+        std::cout << "  L1 <-> Victim: " << traffic.l1_victim.fill_bytes << " fill, "
+                  << traffic.l1_victim.writeback_bytes << " spill" << std::endl;
+    }
+    std::cout << "  Upper <-> L2:  " << traffic.upper_l2.fill_bytes << " fill, "
+              << traffic.upper_l2.writeback_bytes << " write-back" << std::endl;
+    std::cout << "  L2 <-> Memory: " << traffic.l2_memory.fill_bytes << " read, "
+              << traffic.l2_memory.writeback_bytes << " write-back" << std::endl;
+    std::cout << "  DRAM Traffic:  " << traffic.l2_memory.total() << " bytes" << std::endl;
+    
+    std::cout << "\n=== Inclusion Policy ===" << std::endl;
+    std::cout << "  Policy: " << inclusion_policy_name(inclusion)
+              << (swaps_on_victim_hit() ? " with swap-on-victim-hit" : "") << std::endl;
+    std::cout << "  Duplicate Fills (victim hit kept its copy): " << residency.duplicate_fills << std::endl;
+    std::cout << "  Back-Invalidations: " << residency.back_invalidations << std::endl;
+    std::cout << "  Exclusive Moves (L2 -> upper): " << residency.exclusive_moves << std::endl;
+    std::cout << "  Avg Duplicated Blocks (" << residency.samples << " samples): L1&Victim "
+              << residency.average(residency.l1_victim_duplicates) << ", Victim&L2 "
+              << residency.average(residency.victim_l2_duplicates) << ", L1&L2 "
+              << residency.average(residency.l1_l2_duplicates) << std::endl;
+    
+    std::cout << "\n=== Timing Model ===" << std::endl;
+    std::cout << "  Latencies (L1/L2/Mem): " << timing.l1_hit_latency << "/" 
+              << timing.l2_hit_latency << "/" << timing.memory_latency << " cycles" << std::endl;
+    if (use_victim_cache && victim_cache) {
+        VictimCache* vc = static_cast<VictimCache*>(victim_cache);
+        std::cout << "  Victim Lookup Latency: " << timing.victim_latency(vc->get_current_size())
+                  << " cycles at " << vc->get_current_size() << " entries ("
+                  << (timing.probe_mode == VICTIM_PROBE_PARALLEL ? "PARALLEL" : "SERIAL")
+                  << " probe)" << std::endl;
+        std::cout << "  Victim Hit Savings: " << timing_stats.victim_hit_savings << " cycles" << std::endl;
+        std::cout << "  Victim Miss Overhead: " << timing_stats.victim_miss_overhead << " cycles" << std::endl;
+    }
+    std::cout << "  Total Cycles: " << timing_stats.total_cycles << std::endl;
+    std::cout << "  Stall Cycles: " << timing_stats.stall_cycles << std::endl;
+    std::cout << "  AMAT: " << timing_stats.get_amat() << " cycles" << std::endl;
 }
 
 void CacheHierarchySimulator::export_results(const std::string& filename) const {
     std::ofstream out(filename);
     
-    out << "Configuration: ";
-    if (!use_victim_cache) {
-        out << "BASELINE (No Victim Cache)\n";
-    } else if (use_adaptive) {
-        out << "ADAPTIVE VICTIM CACHE (64-256 entries) with SMART INSERTION\n";
-    } else {
-        out << "STATIC VICTIM CACHE (128 entries) with SMART INSERTION\n";
-    }
+    out << "Configuration: " << describe_mode() << "\n";
     
     out << "\nL1 Cache:\n";
     out << "  Hit Rate: " << (l1_cache->get_stats().get_hit_rate() * 100) << "%\n";
@@ -280,12 +1016,51 @@ void CacheHierarchySimulator::export_results(const std::string& filename) const
     out << "  Miss Rate: " << (l2_cache->get_stats().get_miss_rate() * 100) << "%\n";
     out << "  Accesses: " << l2_cache->get_stats().accesses << "\n";
     
+    if (prefetcher) {
+        const PrefetchStats& ps = prefetcher->get_stats();
+        out << "\nPrefetcher (" << prefetcher->get_name() << " at "
+            << (prefetch_level == PREFETCH_AT_L1 ? "L1" : "L2")
+            << (prefetch_into_victim ? ", into victim cache" : "") << "):\n";
+        out << "  Issued: " << ps.issued << "\n";
+        out << "  Useful: " << ps.useful << "\n";
+        out << "  Late: " << ps.late << "\n";
+        out << "  Accuracy: " << (ps.get_accuracy() * 100) << "%\n";
+        out << "  Coverage: " << (ps.get_coverage() * 100) << "%\n";
+        out << "  Timeliness: " << (ps.get_timeliness() * 100) << "%\n";
+    }
+    
     out << "\nMemory:\n";
     out << "  Accesses: " << memory_stats.accesses << "\n";
     double mpki = total_instructions > 0 ? 
         (double)memory_stats.accesses / (total_instructions / 1000.0) : 0.0;
     out << "  MPKI: " << mpki << "\n";
     
+    out << "\nTraffic (bytes):\n";
+    out << "  L1-Victim Fill: " << traffic.l1_victim.fill_bytes << "\n";
+    out << "  L1-Victim Spill: " << traffic.l1_victim.writeback_bytes << "\n";
+    out << "  Upper-L2 Fill: " << traffic.upper_l2.fill_bytes << "\n";
+    out << "  Upper-L2 Write-back: " << traffic.upper_l2.writeback_bytes << "\n";
+    out << "  Memory Read: " << traffic.l2_memory.fill_bytes << "\n";
+    out << "  Memory Write-back: " << traffic.l2_memory.writeback_bytes << "\n";
+    
+    out << "\nInclusion:\n";
+    out << "  Policy: " << inclusion_policy_name(inclusion) << "\n";
+    out << "  Swap On Victim Hit: " << (swaps_on_victim_hit() ? "yes" : "no") << "\n";
+    out << "  Duplicate Fills: " << residency.duplicate_fills << "\n";
+    out << "  Back-Invalidations: " << residency.back_invalidations << "\n";
+    out << "  Exclusive Moves: " << residency.exclusive_moves << "\n";
+    out << "  Avg L1-Victim Duplicates: " << residency.average(residency.l1_victim_duplicates) << "\n";
+    out << "  Avg Victim-L2 Duplicates: " << residency.average(residency.victim_l2_duplicates) << "\n";
+    out << "  Avg L1-L2 Duplicates: " << residency.average(residency.l1_l2_duplicates) << "\n";
+    
+    out << "\nTiming:\n";
+    out << "  Probe Mode: " << (timing.probe_mode == VICTIM_PROBE_PARALLEL ? "PARALLEL" : "SERIAL") << "\n";
+    out << "  Total Cycles: " << timing_stats.total_cycles << "\n";
+    out << "  Stall Cycles: " << timing_stats.stall_cycles << "\n";
+    out << "  Victim Hit Savings: " << timing_stats.victim_hit_savings << "\n";
+    out << "  Victim Miss Overhead: " << timing_stats.victim_miss_overhead << "\n";
+    out << "  AMAT: " << timing_stats.get_amat() << "\n";
+    
     out.close();
 }
 
@@ -302,9 +1077,39 @@ double CacheHierarchySimulator::get_memory_access_rate() const {
         (double)memory_stats.accesses / total_instructions : 0.0;
 }
 
-std::vector<uint64_t> WorkloadGenerator::generate_memory_intensive(uint64_t count) {
+HierarchyCounters CacheHierarchySimulator::get_counters() const {
+    HierarchyCounters counters;
+    counters.instructions = total_instructions;
+    counters.l1_accesses = l1_cache->get_stats().accesses;
+    counters.l1_hits = l1_cache->get_stats().hits;
+    counters.l2_accesses = l2_cache->get_stats().accesses;
+    counters.l2_hits = l2_cache->get_stats().hits;
+    counters.memory_accesses = memory_stats.accesses;
+    counters.cycles = timing_stats.total_cycles;
+    if (use_victim_cache && victim_cache) {
+        counters.victim_hits = static_cast<VictimCache*>(victim_cache)->get_stats().victim_hits;
+    }
+    return counters;
+}
+
+AccessType WorkloadGenerator::access_type(uint64_t index, double write_ratio) {
+    // splitmix64 finaliser: cheap, stateless and well mixed across indices
+    uint64_t z = index + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z = z ^ (z >> 31);
+    return (z % 10000) < write_ratio * 10000 ? ACCESS_WRITE : ACCESS_READ;
+}
+
+// Clock seeds keep their per-generator offsets so traces built in the same
+// second still differ
+static void seed_trace(uint32_t seed, uint32_t clock_offset) {
+    srand(seed == TRACE_SEED_CLOCK ? time(nullptr) + clock_offset : seed);
+}
+
+std::vector<uint64_t> WorkloadGenerator::generate_memory_intensive(uint64_t count, uint32_t seed) {
     std::vector<uint64_t> addresses;
-    srand(time(nullptr) + 1);
+    seed_trace(seed, 1);
     
     uint64_t phase_length = count / 5;
     
@@ -342,9 +1147,9 @@ std::vector<uint64_t> WorkloadGenerator::generate_memory_intensive(uint64_t coun
     return addresses;
 }
 
-std::vector<uint64_t> WorkloadGenerator::generate_compute_intensive(uint64_t count) {
+std::vector<uint64_t> WorkloadGenerator::generate_compute_intensive(uint64_t count, uint32_t seed) {
     std::vector<uint64_t> addresses;
-    srand(time(nullptr));
+    seed_trace(seed, 0);
     
     uint64_t working_set_size = 64;
     uint64_t hot_set_size = 16;
@@ -364,9 +1169,9 @@ std::vector<uint64_t> WorkloadGenerator::generate_compute_intensive(uint64_t cou
     return addresses;
 }
 
-std::vector<uint64_t> WorkloadGenerator::generate_mixed(uint64_t count) {
+std::vector<uint64_t> WorkloadGenerator::generate_mixed(uint64_t count, uint32_t seed) {
     std::vector<uint64_t> addresses;
-    srand(time(nullptr) + 3);
+    seed_trace(seed, 3);
     
     uint64_t phase_length = count / 6;
     
@@ -429,9 +1234,9 @@ std::vector<uint64_t> WorkloadGenerator::generate_streaming(uint64_t count) {
     return addresses;
 }
 
-std::vector<uint64_t> WorkloadGenerator::generate_random_access(uint64_t count) {
+std::vector<uint64_t> WorkloadGenerator::generate_random_access(uint64_t count, uint32_t seed) {
     std::vector<uint64_t> addresses;
-    srand(time(nullptr));
+    seed_trace(seed, 0);
     
     for (uint64_t i = 0; i < count; i++) {
         addresses.push_back((rand() % 8192) * BLOCK_SIZE);
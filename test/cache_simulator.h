@@ -5,19 +5,129 @@
 #include <vector>
 #include <string>
 #include <map>
+#include "../src/prefetch/prefetcher.h"
+#include "../src/monitoring/phase_predictor.h"
+#include "../src/cache/energy_model.h"
+#include "../src/config/sim_config.h"
+#include "../src/monitoring/metrics.h"
+
+struct VictimSpill;
+class IntervalMetricsSink;
 
 #define L1_SIZE 256
 #define L1_ASSOCIATIVITY 8
 #define L2_SIZE 2048
 #define L2_ASSOCIATIVITY 16
 #define BLOCK_SIZE 64
+
+#define L1_HIT_LATENCY 4
+#define VICTIM_BASE_LATENCY 1
+#define VICTIM_ENTRIES_PER_CYCLE 64
+#define L2_HIT_LATENCY 14
+#define MEMORY_LATENCY 200
+
+#define DEFAULT_WRITE_RATIO 0.25
+
+#define RESIDENCY_SAMPLE_INTERVAL 10000
+
+// Seed value that draws a different trace on every run
+#define TRACE_SEED_CLOCK 0
+
+enum AccessType {
+    ACCESS_READ,
+    ACCESS_WRITE
+};
+
+// SERIAL probes L2 only after a victim miss; PARALLEL probes both at once so a
+// victim miss costs max(victim, L2) instead of victim + L2.
+enum VictimProbeMode {
+    VICTIM_PROBE_SERIAL,
+    VICTIM_PROBE_PARALLEL
+};
+
+// How L2 relates to the levels above it. NON_INCLUSIVE fills L2 on every
+// miss but never back-invalidates; INCLUSIVE keeps every upper block in L2 and
+// back-invalidates L1 and the victim cache on L2 evictions; EXCLUSIVE keeps a
+// block in one place only, so L2 is filled by blocks leaving L1/victim cache.
+enum InclusionPolicy {
+    INCLUSION_NON_INCLUSIVE,
+    INCLUSION_INCLUSIVE,
+    INCLUSION_EXCLUSIVE
+};
+
+struct TimingConfig {
+    uint32_t l1_hit_latency;
+    uint32_t victim_base_latency;
+    uint32_t victim_entries_per_cycle;
+    uint32_t l2_hit_latency;
+    uint32_t memory_latency;
+    VictimProbeMode probe_mode;
+    
+    TimingConfig() : l1_hit_latency(L1_HIT_LATENCY), victim_base_latency(VICTIM_BASE_LATENCY),
+                     victim_entries_per_cycle(VICTIM_ENTRIES_PER_CYCLE),
+                     l2_hit_latency(L2_HIT_LATENCY), memory_latency(MEMORY_LATENCY),
+                     probe_mode(VICTIM_PROBE_SERIAL) {}
+    
+    // A fully-associative lookup gets slower as more entries are searched
+    uint32_t victim_latency(uint32_t victim_size) const {
+        return victim_base_latency + 
+               (victim_size + victim_entries_per_cycle - 1) / victim_entries_per_cycle;
+    }
+};
+
+struct TimingStats {
+    uint64_t accesses;
+    uint64_t total_cycles;
+    uint64_t stall_cycles;
+    int64_t victim_hit_savings;
+    uint64_t victim_miss_overhead;
+    
+    TimingStats() : accesses(0), total_cycles(0), stall_cycles(0),
+                    victim_hit_savings(0), victim_miss_overhead(0) {}
+    
+    double get_amat() const {
+        return accesses > 0 ? (double)total_cycles / accesses : 0.0;
+    }
+};
+
+// Bytes moved over one link: fills travel toward the core, write-backs
+// (including clean L1 evictions spilled into the victim cache) away from it
+struct LinkTraffic {
+    uint64_t fill_bytes;
+    uint64_t writeback_bytes;
+    
+    LinkTraffic() : fill_bytes(0), writeback_bytes(0) {}
+    
+    uint64_t total() const { return fill_bytes + writeback_bytes; }
+};
+
+struct TrafficStats {
+    LinkTraffic l1_victim;
+    LinkTraffic upper_l2;
+    LinkTraffic l2_memory;
+};
+
 struct CacheBlock {
     uint64_t tag;
     bool valid;
     uint64_t lru_counter;
     uint64_t access_count;
+    bool prefetched;
+    uint64_t ready_cycle;
+    bool dirty;
     
-    CacheBlock() : tag(0), valid(false), lru_counter(0), access_count(0) {}
+    CacheBlock() : tag(0), valid(false), lru_counter(0), access_count(0),
+                   prefetched(false), ready_cycle(0), dirty(false) {}
+};
+
+// Block displaced by a fill, reported so the caller can move it down a level
+struct EvictedBlock {
+    bool valid;
+    uint64_t address;
+    uint32_t access_count;
+    bool dirty;
+    
+    EvictedBlock() : valid(false), address(0), access_count(0), dirty(false) {}
 };
 
 struct CacheStats {
@@ -25,8 +135,14 @@ struct CacheStats {
     uint64_t hits;
     uint64_t misses;
     uint64_t evictions;
+    uint64_t prefetch_fills;
+    uint64_t unused_prefetch_evictions;
+    uint64_t writebacks_received;
+    uint64_t dirty_evictions;
     
-    CacheStats() : accesses(0), hits(0), misses(0), evictions(0) {}
+    CacheStats() : accesses(0), hits(0), misses(0), evictions(0),
+                   prefetch_fills(0), unused_prefetch_evictions(0),
+                   writebacks_received(0), dirty_evictions(0) {}
     
     double get_hit_rate() const {
         return accesses > 0 ? (double)hits / accesses : 0.0;
@@ -37,6 +153,42 @@ struct CacheStats {
     }
 };
 
+// Raw event counts of a hierarchy run; differences of two snapshots give the
+// statistics of the accesses simulated in between.
+struct HierarchyCounters {
+    uint64_t instructions;
+    uint64_t l1_accesses;
+    uint64_t l1_hits;
+    uint64_t victim_hits;
+    uint64_t l2_accesses;
+    uint64_t l2_hits;
+    uint64_t memory_accesses;
+    uint64_t cycles;
+    
+    HierarchyCounters() : instructions(0), l1_accesses(0), l1_hits(0), victim_hits(0),
+                          l2_accesses(0), l2_hits(0), memory_accesses(0), cycles(0) {}
+};
+
+// Duplicated blocks waste capacity. The *_duplicates fields are summed over
+// periodic residency samples; divide by samples for the typical overlap.
+struct ResidencyStats {
+    uint64_t duplicate_fills;
+    uint64_t back_invalidations;
+    uint64_t exclusive_moves;
+    uint64_t samples;
+    uint64_t l1_victim_duplicates;
+    uint64_t victim_l2_duplicates;
+    uint64_t l1_l2_duplicates;
+    
+    ResidencyStats() : duplicate_fills(0), back_invalidations(0), exclusive_moves(0),
+                       samples(0), l1_victim_duplicates(0), victim_l2_duplicates(0),
+                       l1_l2_duplicates(0) {}
+    
+    double average(uint64_t total) const {
+        return samples > 0 ? (double)total / samples : 0.0;
+    }
+};
+
 class SetAssociativeCache {
 private:
     uint32_t num_sets;
@@ -46,15 +198,26 @@ private:
     CacheStats stats;
     std::string name;
     
-    uint32_t get_set_index(uint64_t address);
+    uint32_t get_set_index(uint64_t address) const;
     uint32_t find_lru_way(uint32_t set);
-    int find_way(uint32_t set, uint64_t tag);
+    int find_way(uint32_t set, uint64_t tag) const;
+    void evict_for_fill(uint32_t set, uint32_t way, EvictedBlock* evicted);
 
 public:
     SetAssociativeCache(std::string cache_name, uint32_t size, uint32_t assoc);
     
-    bool access(uint64_t address, uint64_t* evicted_address = nullptr, uint32_t* evicted_access_count = nullptr);
-    void insert(uint64_t address);
+    // prefetch_ready is set to the fill-complete cycle when the hit consumed a prefetched block
+    bool access(uint64_t address, bool is_write = false, EvictedBlock* evicted = nullptr,
+                uint64_t* prefetch_ready = nullptr);
+    // Counts as an access like access(), but a miss does not allocate
+    bool probe(uint64_t address, uint64_t* prefetch_ready = nullptr);
+    void insert(uint64_t address, EvictedBlock* evicted = nullptr);
+    bool invalidate(uint64_t address, bool* was_dirty = nullptr);
+    bool prefetch_fill(uint64_t address, uint64_t ready_cycle, EvictedBlock* evicted = nullptr);
+    void write_back(uint64_t address, EvictedBlock* evicted = nullptr);
+    void mark_dirty(uint64_t address);
+    bool contains(uint64_t address) const;
+    void get_resident_addresses(std::vector<uint64_t>& out) const;
     
     const CacheStats& get_stats() const { return stats; }
     void print_stats() const;
@@ -72,35 +235,126 @@ private:
     
     bool use_victim_cache;
     bool use_adaptive;
+    uint32_t configured_victim_size;  // fixed size, or the adaptive start size
     
     CacheStats memory_stats;
+    TimingConfig timing;
+    TimingStats timing_stats;
+    TrafficStats traffic;
     uint64_t total_instructions;
     uint64_t instructions_since_last_adapt;
     uint64_t adaptation_interval;
+    
+    Prefetcher* prefetcher;
+    PrefetchLevel prefetch_level;
+    bool prefetch_into_victim;
+    std::vector<uint64_t> prefetch_candidates;
+    std::vector<VictimSpill> victim_spills;
+    
+    InclusionPolicy inclusion;
+    bool swap_on_victim_hit;
+    ResidencyStats residency;
+    std::vector<uint64_t> residency_scratch;
+    
+    IntervalMetricsSink* interval_sink;
+    uint64_t sink_interval;
+    uint64_t sink_interval_start;  // total_instructions when the open interval began
+    uint64_t intervals_emitted;
+    uint64_t sink_adaptations;
+    IntervalCounter interval_l1_accesses;
+    IntervalCounter interval_l1_hits;
+    IntervalCounter interval_l2_accesses;
+    IntervalCounter interval_l2_hits;
+    IntervalCounter interval_victim_lookups;
+    IntervalCounter interval_victim_hits;
+    
+    std::string describe_mode() const;
+    // Exclusion implies swapping: keeping a victim hit's copy would duplicate it in L1
+    bool swaps_on_victim_hit() const { return swap_on_victim_hit || inclusion == INCLUSION_EXCLUSIVE; }
+    void account_latency(uint64_t cycles);
+    void spill_l1_eviction(const EvictedBlock& evicted);
+    void drain_victim_spills();
+    void spill_to_l2(uint64_t address, bool dirty);
+    void handle_l2_eviction(const EvictedBlock& evicted);
+    void sample_residency();
+    void close_interval_counters();
+    void emit_interval();
+    uint64_t wait_for_prefetch(uint64_t ready_cycle, uint64_t elapsed);
+    void count_uncovered_miss(PrefetchLevel level);
+    void train_prefetcher(PrefetchLevel level, uint64_t address, bool miss);
+    void issue_prefetch(uint64_t address);
 
 public:
-    CacheHierarchySimulator(bool enable_victim, bool enable_adaptive);
+    CacheHierarchySimulator(bool enable_victim, bool enable_adaptive,
+                            const SimConfig& config = SimConfig());
     ~CacheHierarchySimulator();
     
-    void access_memory(uint64_t address);
+    void access_memory(uint64_t address, AccessType type = ACCESS_READ);
     void simulate_instruction();
     void check_adaptation();
     
+    // Appends one IntervalRecord every `interval` instructions (0 uses the
+    // adaptation interval); the sink must stay open while attached
+    void attach_interval_sink(IntervalMetricsSink* sink, uint64_t interval = 0);
+    // Emits the trailing partial interval, if any, and stops appending
+    void detach_interval_sink();
+    
+    void set_timing_config(const TimingConfig& config);
+    const TimingConfig& get_timing_config() const { return timing; }
+    const TimingStats& get_timing_stats() const { return timing_stats; }
+    double get_amat() const { return timing_stats.get_amat(); }
+    
+    void attach_prefetcher(PrefetcherType type, PrefetchLevel level, bool into_victim = false);
+    const Prefetcher* get_prefetcher() const { return prefetcher; }
+    
+    const TrafficStats& get_traffic_stats() const { return traffic; }
+    
+    void set_inclusion_policy(InclusionPolicy policy);
+    InclusionPolicy get_inclusion_policy() const { return inclusion; }
+    void set_swap_on_victim_hit(bool enable) { swap_on_victim_hit = enable; }
+    const ResidencyStats& get_residency_stats() const { return residency; }
+    
+    // Adaptive mode only: resize ahead of predicted phase transitions
+    void set_phase_prediction(bool enable);
+    PredictionStats get_prediction_stats() const;
+    
+    // Adaptive mode only: "hybrid" (default), "mrc", "pid" or "bandit"; false if unknown
+    bool set_adaptation_policy(const std::string& name);
+    void set_entry_cost(double cost);
+    // PID setpoint on "hit-rate" or "occupancy"; a negative value keeps the default
+    bool set_control_setpoint(const std::string& metric, double value);
+    // MRC objective: "hit-rate" (default) or "edp"
+    bool set_objective(const std::string& name);
+    
+    void set_power_gating(bool enable);
+    // Duel the configured bypass thresholds against lenient ones (DIP-style)
+    void set_bypass_dueling(bool enable);
+    EnergyStats get_victim_energy() const;
+    
+    static const char* inclusion_policy_name(InclusionPolicy policy);
+    static bool parse_inclusion_policy(const std::string& name, InclusionPolicy& policy);
+    static bool is_adaptation_policy(const std::string& name);
+    
     void print_summary() const;
     void export_results(const std::string& filename) const;
     
     double get_l1_hit_rate() const;
     double get_l2_hit_rate() const;
     double get_memory_access_rate() const;
+    HierarchyCounters get_counters() const;
 };
 
 class WorkloadGenerator {
 public:
-    static std::vector<uint64_t> generate_memory_intensive(uint64_t count);
-    static std::vector<uint64_t> generate_compute_intensive(uint64_t count);
-    static std::vector<uint64_t> generate_mixed(uint64_t count);
+    // The same non-zero seed always yields the same trace
+    static std::vector<uint64_t> generate_memory_intensive(uint64_t count, uint32_t seed = TRACE_SEED_CLOCK);
+    static std::vector<uint64_t> generate_compute_intensive(uint64_t count, uint32_t seed = TRACE_SEED_CLOCK);
+    static std::vector<uint64_t> generate_mixed(uint64_t count, uint32_t seed = TRACE_SEED_CLOCK);
     static std::vector<uint64_t> generate_streaming(uint64_t count);
-    static std::vector<uint64_t> generate_random_access(uint64_t count);
+    static std::vector<uint64_t> generate_random_access(uint64_t count, uint32_t seed = TRACE_SEED_CLOCK);
+    
+    // Deterministic per-index read/write mix, so every run of a trace sees the same stores
+    static AccessType access_type(uint64_t index, double write_ratio);
 };
 
 #endif
@@ -1,9 +1,18 @@
 #include "cache_simulator.h"
+#include "../src/cache/victim_cache.h"
+#include "../src/monitoring/simpoint.h"
+#include "../src/monitoring/profiler.h"
+#include "../src/monitoring/host_counters.h"
+#include "../src/monitoring/interval_sink.h"
+#include "../benchmarks/trace_kernels.h"
 #include <iostream>
 #include <iomanip>
 #include <fstream>
 #include <vector>
 #include <string>
+#include <cmath>
+#include <algorithm>
+#include <sstream>
 
 struct SimulationResult {
     std::string config_name;
@@ -12,32 +21,113 @@ struct SimulationResult {
     double l2_miss_rate;
     double mpki;
     double victim_hit_rate;
+    double amat;
+    uint64_t stall_cycles;
+    uint64_t memory_traffic_bytes;
+    HostCounterSample host;
 };
 
+static TimingConfig timing_config;
+static PrefetcherType prefetcher_type = PREFETCHER_NONE;
+static PrefetchLevel prefetch_level = PREFETCH_AT_L1;
+static bool prefetch_into_victim = false;
+static double write_ratio = DEFAULT_WRITE_RATIO;
+static InclusionPolicy inclusion_policy = INCLUSION_NON_INCLUSIVE;
+static bool swap_on_victim_hit = false;
+static bool predict_phases = false;
+static std::string adaptation_policy = "hybrid";
+static double entry_cost = 0.0;  // 0 keeps the controller default
+static std::string control_metric = "hit-rate";
+static double control_setpoint = -1.0;
+static std::string objective = "hit-rate";
+static bool power_gating = true;
+static bool bypass_dueling = false;
+static SimConfig sim_config;
+static bool host_counters_enabled = false;
+static HostCounters host_counters;
+static std::string interval_log_prefix;  // empty disables the interval log
+static IntervalSinkFormat interval_log_format = SINK_FORMAT_CSV;
+static uint64_t interval_log_length = 0;
+
+// Victim sizes as configured, for banners and reports
+static std::string static_victim_label() {
+    return std::to_string(sim_config.static_victim_size) + " entries";
+}
+
+static std::string adaptive_victim_label() {
+    return std::to_string(MIN_VICTIM_SIZE) + "-" + std::to_string(MAX_VICTIM_SIZE) +
+           " entries, starts at " + std::to_string(sim_config.adaptive_start_size);
+}
+
+void configure_simulator(CacheHierarchySimulator& sim) {
+    sim.set_timing_config(timing_config);
+    sim.set_inclusion_policy(inclusion_policy);
+    sim.set_swap_on_victim_hit(swap_on_victim_hit);
+    sim.set_phase_prediction(predict_phases);
+    sim.set_adaptation_policy(adaptation_policy);
+    if (entry_cost > 0.0) {
+        sim.set_entry_cost(entry_cost);
+    }
+    sim.set_control_setpoint(control_metric, control_setpoint);
+    sim.set_objective(objective);
+    sim.set_power_gating(power_gating);
+    sim.set_bypass_dueling(bypass_dueling);
+    if (prefetcher_type != PREFETCHER_NONE) {
+        sim.attach_prefetcher(prefetcher_type, prefetch_level, prefetch_into_victim);
+    }
+}
+
 void run_workload(CacheHierarchySimulator& sim, const std::vector<uint64_t>& addresses, const std::string& workload_name) {
     std::cout << "\n  Running " << workload_name << " (" << addresses.size() << " accesses)..." << std::endl;
     
-    for (uint64_t addr : addresses) {
-        sim.access_memory(addr);
+    for (uint64_t i = 0; i < addresses.size(); i++) {
+        sim.access_memory(addresses[i], WorkloadGenerator::access_type(i, write_ratio));
         sim.simulate_instruction();
     }
 }
 
-SimulationResult simulate_configuration(const std::string& config, const std::vector<uint64_t>& addresses, const std::string& workload) {
-    bool use_victim = (config != "baseline");
-    bool use_adaptive = (config == "adaptive");
-    
-    CacheHierarchySimulator sim(use_victim, use_adaptive);
-    run_workload(sim, addresses, workload);
-    
+SimulationResult collect_result(const CacheHierarchySimulator& sim, const std::string& config) {
     SimulationResult result;
     result.config_name = config;
     result.l1_hit_rate = sim.get_l1_hit_rate();
     result.l2_hit_rate = sim.get_l2_hit_rate();
     result.l2_miss_rate = 1.0 - sim.get_l2_hit_rate();
     result.mpki = sim.get_memory_access_rate() * 1000.0;
+    result.amat = sim.get_amat();
+    result.stall_cycles = sim.get_timing_stats().stall_cycles;
+    result.memory_traffic_bytes = sim.get_traffic_stats().l2_memory.total();
+    return result;
+}
+
+SimulationResult simulate_configuration(const std::string& config, const std::vector<uint64_t>& addresses, const std::string& workload) {
+    bool use_victim = (config != "baseline");
+    bool use_adaptive = (config == "adaptive");
+    
+    CacheHierarchySimulator sim(use_victim, use_adaptive, sim_config);
+    configure_simulator(sim);
+    IntervalMetricsSink interval_log;
+    if (!interval_log_prefix.empty() &&
+        interval_log.open(interval_log_prefix + "_" + config + "_" + workload +
+                          IntervalMetricsSink::file_extension(interval_log_format), interval_log_format)) {
+        sim.attach_interval_sink(&interval_log, interval_log_length);
+    }
+    host_counters.measure_begin();
+    run_workload(sim, addresses, workload);
+    HostCounterSample host = host_counters.measure_end();
+    if (interval_log.is_open()) {
+        sim.detach_interval_sink();
+        interval_log.close();
+        std::cout << "  Interval log: " << interval_log.get_records() << " records to " << interval_log.get_path()
+                  << " (" << interval_log.get_stalls() << " writer stalls)" << std::endl;
+    }
+    
+    SimulationResult result = collect_result(sim, config);
+    result.host = host;
     
     sim.print_summary();
+    if (host.any_counted()) {
+        host.print();
+    }
     sim.export_results("results/" + config + "_" + workload + ".txt");
     
     return result;
@@ -57,20 +147,47 @@ void compare_results(const std::vector<SimulationResult>& results, const std::st
     
     std::cout << "\nMetric              Baseline    Static VC   Adaptive" << std::endl;
     std::cout << "--------------------------------------------------------" << std::endl;
-
+    
     std::cout << "L1 Hit Rate       " << std::setw(8) << std::fixed << std::setprecision(2) 
               << (baseline.l1_hit_rate * 100) << "%   " 
               << std::setw(8) << (static_vc.l1_hit_rate * 100) << "%   "
               << std::setw(8) << (adaptive_vc.l1_hit_rate * 100) << "%" << std::endl;
-
+    
     std::cout << "L2 Miss Rate      " << std::setw(8) << (baseline.l2_miss_rate * 100) << "%   " 
               << std::setw(8) << (static_vc.l2_miss_rate * 100) << "%   "
               << std::setw(8) << (adaptive_vc.l2_miss_rate * 100) << "%" << std::endl;
-
+    
     std::cout << "MPKI              " << std::setw(9) << baseline.mpki << "   " 
               << std::setw(9) << static_vc.mpki << "   "
               << std::setw(9) << adaptive_vc.mpki << std::endl;
-
+    
+    std::cout << "AMAT (cycles)     " << std::setw(9) << baseline.amat << "   " 
+              << std::setw(9) << static_vc.amat << "   "
+              << std::setw(9) << adaptive_vc.amat << std::endl;
+    
+    std::cout << "Stall Cycles      " << std::setw(9) << baseline.stall_cycles << "   " 
+              << std::setw(9) << static_vc.stall_cycles << "   "
+              << std::setw(9) << adaptive_vc.stall_cycles << std::endl;
+    
+    std::cout << "DRAM Traffic (KB) " << std::setw(9) << baseline.memory_traffic_bytes / 1024 << "   " 
+              << std::setw(9) << static_vc.memory_traffic_bytes / 1024 << "   "
+              << std::setw(9) << adaptive_vc.memory_traffic_bytes / 1024 << std::endl;
+    
+    if (baseline.host.any_counted()) {
+        std::cout << "Host IPC          " << std::setw(9) << std::setprecision(3) << baseline.host.get_ipc() << "   "
+                  << std::setw(9) << static_vc.host.get_ipc() << "   "
+                  << std::setw(9) << adaptive_vc.host.get_ipc() << std::endl;
+        const HostEvent miss_events[] = {HOST_LLC_MISSES, HOST_BRANCH_MISSES, HOST_DTLB_MISSES};
+        const char* miss_labels[] = {"Host LLC MPKI     ", "Host Branch MPKI  ", "Host dTLB MPKI    "};
+        for (int m = 0; m < 3; m++) {
+            // -1 marks an event this host could not count
+            std::cout << miss_labels[m] << std::setw(9) << baseline.host.get_per_kilo_instruction(miss_events[m]) << "   "
+                      << std::setw(9) << static_vc.host.get_per_kilo_instruction(miss_events[m]) << "   "
+                      << std::setw(9) << adaptive_vc.host.get_per_kilo_instruction(miss_events[m]) << std::endl;
+        }
+        std::cout << std::setprecision(2);
+    }
+    
     std::cout << "--------------------------------------------------------" << std::endl;
     
     double static_improvement = ((static_vc.l2_hit_rate - baseline.l2_hit_rate) / baseline.l2_hit_rate) * 100;
@@ -108,7 +225,12 @@ void save_comparison_report(const std::map<std::string, std::vector<SimulationRe
     report << "Configuration:\n";
     report << "  L1 Cache:  256 entries, 8-way set associative\n";
     report << "  L2 Cache:  2048 entries, 16-way set associative\n";
-    report << "  Victim:    128 entries (static), 64-256 entries (adaptive, starts at 80)\n\n";
+    report << "  Victim:    " << static_victim_label() << " static, adaptive " << adaptive_victim_label() << "\n";
+    report << "  Latency:   L1 " << timing_config.l1_hit_latency << ", L2 " << timing_config.l2_hit_latency
+           << ", memory " << timing_config.memory_latency << " cycles, victim "
+           << timing_config.victim_base_latency << " + size/" << timing_config.victim_entries_per_cycle
+           << (timing_config.probe_mode == VICTIM_PROBE_PARALLEL ? " (parallel probe)" : " (serial probe)") << "\n";
+    report << "  Writes:    " << (write_ratio * 100) << "% of accesses\n\n";
     
     for (const auto& [workload, results] : all_results) {
         report << "---------------------------------------------------------------\n";
@@ -126,13 +248,19 @@ void save_comparison_report(const std::map<std::string, std::vector<SimulationRe
         report << "  L1 Hit Rate:    " << (baseline.l1_hit_rate * 100) << "%\n";
         report << "  L2 Hit Rate:    " << (baseline.l2_hit_rate * 100) << "%\n";
         report << "  L2 Miss Rate:   " << (baseline.l2_miss_rate * 100) << "%\n";
-        report << "  MPKI:           " << baseline.mpki << "\n\n";
+        report << "  MPKI:           " << baseline.mpki << "\n";
+        report << "  AMAT:           " << baseline.amat << " cycles\n";
+        report << "  Stall Cycles:   " << baseline.stall_cycles << "\n";
+        report << "  DRAM Traffic:   " << baseline.memory_traffic_bytes << " bytes\n\n";
         
-        report << "Static Victim Cache (128 entries):\n";
+        report << "Static Victim Cache (" << static_victim_label() << "):\n";
         report << "  L1 Hit Rate:    " << (static_vc.l1_hit_rate * 100) << "%\n";
         report << "  L2 Hit Rate:    " << (static_vc.l2_hit_rate * 100) << "%\n";
         report << "  L2 Miss Rate:   " << (static_vc.l2_miss_rate * 100) << "%\n";
-        report << "  MPKI:           " << static_vc.mpki << "\n\n";
+        report << "  MPKI:           " << static_vc.mpki << "\n";
+        report << "  AMAT:           " << static_vc.amat << " cycles\n";
+        report << "  Stall Cycles:   " << static_vc.stall_cycles << "\n";
+        report << "  DRAM Traffic:   " << static_vc.memory_traffic_bytes << " bytes\n\n";
         
         double static_improvement = ((static_vc.l2_hit_rate - baseline.l2_hit_rate) / baseline.l2_hit_rate) * 100;
         double l2_miss_reduction_static = (baseline.l2_miss_rate - static_vc.l2_miss_rate) * 100;
@@ -141,11 +269,14 @@ void save_comparison_report(const std::map<std::string, std::vector<SimulationRe
         report << "    L2 Hit Rate:        " << std::showpos << static_improvement << "%\n";
         report << "    L2 Miss Reduction:  " << std::noshowpos << l2_miss_reduction_static << " pp\n\n";
         
-        report << "Adaptive Victim Cache (64-256 entries, starts at 80):\n";
+        report << "Adaptive Victim Cache (" << adaptive_victim_label() << "):\n";
         report << "  L1 Hit Rate:    " << (adaptive_vc.l1_hit_rate * 100) << "%\n";
         report << "  L2 Hit Rate:    " << (adaptive_vc.l2_hit_rate * 100) << "%\n";
         report << "  L2 Miss Rate:   " << (adaptive_vc.l2_miss_rate * 100) << "%\n";
-        report << "  MPKI:           " << adaptive_vc.mpki << "\n\n";
+        report << "  MPKI:           " << adaptive_vc.mpki << "\n";
+        report << "  AMAT:           " << adaptive_vc.amat << " cycles\n";
+        report << "  Stall Cycles:   " << adaptive_vc.stall_cycles << "\n";
+        report << "  DRAM Traffic:   " << adaptive_vc.memory_traffic_bytes << " bytes\n\n";
         
         double adaptive_improvement = ((adaptive_vc.l2_hit_rate - baseline.l2_hit_rate) / baseline.l2_hit_rate) * 100;
         double l2_miss_reduction_adaptive = (baseline.l2_miss_rate - adaptive_vc.l2_miss_rate) * 100;
@@ -157,6 +288,23 @@ void save_comparison_report(const std::map<std::string, std::vector<SimulationRe
         
         report << "  Improvement over Static:\n";
         report << "    Additional Gain:    " << std::showpos << adaptive_over_static << "%\n\n";
+        report << std::noshowpos;
+        
+        if (baseline.host.any_counted()) {
+            report << "Host counters (simulator process, baseline / static / adaptive):\n";
+            for (int e = 0; e < HOST_NUM_EVENTS; e++) {
+                report << "  " << std::left << std::setw(14) << HostCounters::event_name((HostEvent)e) << std::right;
+                for (const SimulationResult* r : {&baseline, &static_vc, &adaptive_vc}) {
+                    if (r->host.counted[e]) {
+                        report << std::setw(14) << r->host.values[e];
+                    } else {
+                        report << std::setw(14) << "n/a";
+                    }
+                }
+                report << "\n";
+            }
+            report << "\n";
+        }
     }
     
     report << "===============================================================\n";
@@ -167,7 +315,495 @@ void save_comparison_report(const std::map<std::string, std::vector<SimulationRe
     std::cout << "\nDetailed report saved to: results/REAL_RESULTS_COMPARISON.txt\n";
 }
 
-int main() {
+// Simulates only the SimPoint representatives. Each one is preceded by a
+// functional warm-up over the accesses leading into it; together with the state
+// carried over from the previous representative this acts as the checkpoint.
+SimulationResult simulate_sampled(const std::string& config, const std::vector<uint64_t>& addresses,
+                                  const std::vector<SimPoint>& simpoints, uint64_t& simulated_accesses) {
+    bool use_victim = (config != "baseline");
+    bool use_adaptive = (config == "adaptive");
+    
+    CacheHierarchySimulator sim(use_victim, use_adaptive, sim_config);
+    configure_simulator(sim);
+    
+    double instructions = 0, l1_accesses = 0, l1_hits = 0;
+    double l2_accesses = 0, l2_hits = 0, memory_accesses = 0, cycles = 0;
+    uint64_t position = 0;
+    simulated_accesses = 0;
+    
+    for (const auto& point : simpoints) {
+        uint64_t warm_start = point.start > SIMPOINT_WARMUP_LENGTH ? point.start - SIMPOINT_WARMUP_LENGTH : 0;
+        warm_start = std::max(warm_start, position);
+        
+        for (uint64_t i = warm_start; i < point.start; i++) {
+            sim.access_memory(addresses[i], WorkloadGenerator::access_type(i, write_ratio));
+            sim.simulate_instruction();
+        }
+        
+        HierarchyCounters before = sim.get_counters();
+        for (uint64_t i = point.start; i < point.start + point.length; i++) {
+            sim.access_memory(addresses[i], WorkloadGenerator::access_type(i, write_ratio));
+            sim.simulate_instruction();
+        }
+        HierarchyCounters after = sim.get_counters();
+        
+        double scale = (double)point.cluster_accesses / point.length;
+        instructions += (after.instructions - before.instructions) * scale;
+        l1_accesses += (after.l1_accesses - before.l1_accesses) * scale;
+        l1_hits += (after.l1_hits - before.l1_hits) * scale;
+        l2_accesses += (after.l2_accesses - before.l2_accesses) * scale;
+        l2_hits += (after.l2_hits - before.l2_hits) * scale;
+        memory_accesses += (after.memory_accesses - before.memory_accesses) * scale;
+        cycles += (after.cycles - before.cycles) * scale;
+        
+        simulated_accesses += point.start + point.length - warm_start;
+        position = point.start + point.length;
+    }
+    
+    SimulationResult result;
+    result.config_name = config;
+    result.l1_hit_rate = l1_accesses > 0 ? l1_hits / l1_accesses : 0.0;
+    result.l2_hit_rate = l2_accesses > 0 ? l2_hits / l2_accesses : 0.0;
+    result.l2_miss_rate = 1.0 - result.l2_hit_rate;
+    result.mpki = instructions > 0 ? memory_accesses / (instructions / 1000.0) : 0.0;
+    result.amat = l1_accesses > 0 ? cycles / l1_accesses : 0.0;
+    result.stall_cycles = (uint64_t)(cycles - l1_accesses * timing_config.l1_hit_latency);
+    result.memory_traffic_bytes = 0;
+    return result;
+}
+
+void run_simpoint_evaluation(uint64_t interval_length, uint32_t max_clusters) {
+    std::cout << "\n============================================================" << std::endl;
+    std::cout << "     SIMPOINT SAMPLED SIMULATION - ERROR VS FULL RUN" << std::endl;
+    std::cout << "============================================================" << std::endl;
+    
+    std::ofstream report("results/SIMPOINT_ERROR_REPORT.txt");
+    report << "===============================================================\n";
+    report << "     SIMPOINT SAMPLED SIMULATION - ERROR VS FULL RUN\n";
+    report << "===============================================================\n\n";
+    report << "Interval length: " << interval_length << " accesses\n";
+    report << "Max clusters:    " << max_clusters << "\n";
+    report << "Warm-up length:  " << SIMPOINT_WARMUP_LENGTH << " accesses\n\n";
+    
+    std::vector<std::pair<std::string, std::vector<uint64_t>>> workloads;
+    workloads.push_back({"memory_intensive", WorkloadGenerator::generate_memory_intensive(500000)});
+    workloads.push_back({"compute_intensive", WorkloadGenerator::generate_compute_intensive(500000)});
+    workloads.push_back({"mixed", WorkloadGenerator::generate_mixed(500000)});
+    
+    const std::vector<std::string> configs = {"baseline", "static", "adaptive"};
+    
+    for (const auto& [workload, addresses] : workloads) {
+        SimPointAnalyzer analyzer(interval_length, max_clusters);
+        std::vector<SimPoint> simpoints = analyzer.analyze(addresses);
+        analyzer.print_simpoints();
+        analyzer.export_simpoints("results/simpoints_" + workload + ".csv");
+        
+        report << "---------------------------------------------------------------\n";
+        report << "WORKLOAD: " << workload << " (" << analyzer.get_num_intervals() << " intervals, "
+               << simpoints.size() << " representatives)\n";
+        report << "---------------------------------------------------------------\n";
+        report << "Config      L1 Hit (full/sampled)   L2 Hit (full/sampled)   MPKI (full/sampled)   MPKI Err   Simulated\n";
+        
+        for (const auto& config : configs) {
+            bool use_victim = (config != "baseline");
+            bool use_adaptive = (config == "adaptive");
+            
+            SimulationResult full;
+            {
+                CacheHierarchySimulator sim(use_victim, use_adaptive, sim_config);
+                configure_simulator(sim);
+                run_workload(sim, addresses, workload);
+                full = collect_result(sim, config);
+            }
+            
+            uint64_t simulated_accesses = 0;
+            SimulationResult sampled = simulate_sampled(config, addresses, simpoints, simulated_accesses);
+            
+            double mpki_error = full.mpki > 0 ? std::abs(sampled.mpki - full.mpki) / full.mpki * 100 : 0.0;
+            double simulated_fraction = (double)simulated_accesses / addresses.size() * 100;
+            
+            std::cout << "\n[SimPoint] " << workload << " / " << config << std::fixed << std::setprecision(2)
+                      << ": L1 " << (full.l1_hit_rate * 100) << "% vs " << (sampled.l1_hit_rate * 100) << "%"
+                      << ", L2 " << (full.l2_hit_rate * 100) << "% vs " << (sampled.l2_hit_rate * 100) << "%"
+                      << ", MPKI " << full.mpki << " vs " << sampled.mpki
+                      << " (error " << mpki_error << "%, simulated " << simulated_fraction << "% of trace)"
+                      << std::endl;
+            
+            report << std::left << std::setw(12) << config << std::right << std::fixed << std::setprecision(2)
+                   << std::setw(8) << (full.l1_hit_rate * 100) << "% / " << std::setw(6) << (sampled.l1_hit_rate * 100) << "%"
+                   << std::setw(11) << (full.l2_hit_rate * 100) << "% / " << std::setw(6) << (sampled.l2_hit_rate * 100) << "%"
+                   << std::setw(11) << full.mpki << " / " << std::setw(7) << sampled.mpki
+                   << std::setw(10) << mpki_error << "%"
+                   << std::setw(10) << simulated_fraction << "%\n";
+        }
+        report << "\n";
+    }
+    
+    report << "===============================================================\n";
+    report << "                    END OF REPORT\n";
+    report << "===============================================================\n";
+    report.close();
+    std::cout << "\nSimPoint error report saved to: results/SIMPOINT_ERROR_REPORT.txt\n";
+}
+
+// Runs the adaptive configuration over several back-to-back periods of the
+// mixed workload, once reacting to phase changes and once pre-adapting to
+// predicted ones
+void run_phase_prediction_evaluation() {
+    const uint64_t period_length = 600000;
+    const int periods = 5;
+    
+    std::cout << "\n============================================================" << std::endl;
+    std::cout << "     PHASE PREDICTION - REACTIVE VS PROACTIVE ADAPTATION" << std::endl;
+    std::cout << "============================================================" << std::endl;
+    
+    std::vector<uint64_t> trace;
+    std::vector<uint64_t> period = WorkloadGenerator::generate_mixed(period_length);
+    for (int p = 0; p < periods; p++) {
+        trace.insert(trace.end(), period.begin(), period.end());
+    }
+    
+    struct PredictionRun {
+        std::string mode;
+        double victim_hit_rate;
+        double l2_hit_rate;
+        double amat;
+        PredictionStats prediction;
+    };
+    std::vector<PredictionRun> runs;
+    
+    for (bool proactive : {false, true}) {
+        CacheHierarchySimulator sim(true, true, sim_config);
+        configure_simulator(sim);
+        sim.set_phase_prediction(proactive);
+        run_workload(sim, trace, "periodic_mixed");
+        
+        HierarchyCounters counters = sim.get_counters();
+        uint64_t victim_lookups = counters.l1_accesses - counters.l1_hits;
+        PredictionRun run;
+        run.mode = proactive ? "proactive" : "reactive";
+        run.victim_hit_rate = victim_lookups > 0 ? (double)counters.victim_hits / victim_lookups : 0.0;
+        run.l2_hit_rate = sim.get_l2_hit_rate();
+        run.amat = sim.get_amat();
+        run.prediction = sim.get_prediction_stats();
+        runs.push_back(run);
+    }
+    
+    std::ofstream report("results/PHASE_PREDICTION_REPORT.txt");
+    std::ostringstream table;
+    table << "Trace: " << periods << " periods of generate_mixed(" << period_length << ")\n\n";
+    table << std::setw(12) << "Mode" << std::setw(14) << "Victim Hit" << std::setw(12) << "L2 Hit"
+          << std::setw(10) << "AMAT" << std::setw(14) << "Next-Phase" << std::setw(10) << "Onset" << "\n";
+    table << std::string(72, '-') << "\n";
+    for (const auto& run : runs) {
+        table << std::setw(12) << run.mode
+              << std::setw(13) << std::fixed << std::setprecision(2) << (run.victim_hit_rate * 100) << "%"
+              << std::setw(11) << (run.l2_hit_rate * 100) << "%"
+              << std::setw(10) << run.amat
+              << std::setw(13) << (run.prediction.get_accuracy() * 100) << "%"
+              << std::setw(9) << (run.prediction.get_onset_accuracy() * 100) << "%\n";
+    }
+    table << "\nPhase transitions seen: " << runs[0].prediction.transitions
+          << " (" << runs[0].prediction.predicted << " with a prediction)\n";
+    table << "Victim hit rate recovered by pre-adapting: " << std::showpos
+          << ((runs[1].victim_hit_rate - runs[0].victim_hit_rate) * 100) << std::noshowpos << " pp\n";
+    
+    std::cout << "\n" << table.str();
+    report << table.str();
+    report.close();
+    std::cout << "\nPhase prediction report saved to: results/PHASE_PREDICTION_REPORT.txt\n";
+}
+
+// Every size policy on the same three traces; the configured static cache is
+// the reference row
+void run_policy_comparison() {
+    const uint64_t trace_length = 500000;
+    const char* policies[] = {"hybrid", "mrc", "pid", "bandit", "mrc-edp"};
+    
+    std::cout << "\n============================================================" << std::endl;
+    std::cout << "     SIZE POLICY COMPARISON" << std::endl;
+    std::cout << "============================================================" << std::endl;
+    
+    std::vector<std::pair<std::string, std::vector<uint64_t>>> workloads;
+    workloads.push_back({"memory_intensive", WorkloadGenerator::generate_memory_intensive(trace_length)});
+    workloads.push_back({"compute_intensive", WorkloadGenerator::generate_compute_intensive(trace_length)});
+    workloads.push_back({"mixed", WorkloadGenerator::generate_mixed(trace_length)});
+    
+    std::ostringstream table;
+    table << std::setw(20) << "Workload" << std::setw(10) << "Policy" << std::setw(14) << "Victim Hit"
+          << std::setw(12) << "L2 Hit" << std::setw(10) << "AMAT" << std::setw(10) << "MPKI"
+          << std::setw(12) << "Energy nJ" << std::setw(12) << "EDP" << "\n";
+    table << std::string(100, '-') << "\n";
+    
+    for (const auto& workload : workloads) {
+        std::vector<std::string> configs = {"static"};
+        configs.insert(configs.end(), std::begin(policies), std::end(policies));
+        
+        for (const std::string& config : configs) {
+            bool adaptive = (config != "static");
+            CacheHierarchySimulator sim(true, adaptive, sim_config);
+            configure_simulator(sim);
+            if (config == "mrc-edp") {
+                sim.set_adaptation_policy("mrc");
+                sim.set_objective("edp");
+            } else if (adaptive) {
+                sim.set_adaptation_policy(config);
+            }
+            run_workload(sim, workload.second, workload.first);
+            if (adaptive) {
+                sim.print_summary();
+            }
+            
+            HierarchyCounters counters = sim.get_counters();
+            uint64_t victim_lookups = counters.l1_accesses - counters.l1_hits;
+            double victim_hit_rate = victim_lookups > 0 ? (double)counters.victim_hits / victim_lookups : 0.0;
+            table << std::setw(20) << workload.first
+                  << std::setw(10) << config
+                  << std::setw(13) << std::fixed << std::setprecision(2) << (victim_hit_rate * 100) << "%"
+                  << std::setw(11) << (sim.get_l2_hit_rate() * 100) << "%"
+                  << std::setw(10) << sim.get_amat()
+                  << std::setw(10) << (sim.get_memory_access_rate() * 1000.0)
+                  << std::setw(12) << (sim.get_victim_energy().total_pj() / 1000.0)
+                  << std::setw(12) << std::scientific << std::setprecision(3)
+                  << sim.get_victim_energy().edp() << std::fixed << "\n";
+        }
+        table << "\n";
+    }
+    
+    std::ofstream report("results/POLICY_COMPARISON_REPORT.txt");
+    std::cout << "\n" << table.str();
+    report << table.str();
+    report.close();
+    std::cout << "Policy comparison report saved to: results/POLICY_COMPARISON_REPORT.txt\n";
+}
+
+// Feeds kernel accesses straight into a hierarchy, with the kernel's own
+// loads and stores instead of the --write-ratio mix
+struct SimulatorSink {
+    CacheHierarchySimulator& sim;
+    uint64_t accesses;
+    
+    SimulatorSink(CacheHierarchySimulator& simulator) : sim(simulator), accesses(0) {}
+    
+    void access(uint64_t address, bool is_write) {
+        sim.access_memory(address, is_write ? ACCESS_WRITE : ACCESS_READ);
+        sim.simulate_instruction();
+        accesses++;
+    }
+};
+
+// Baseline, static and adaptive hierarchies on each algorithm kernel (or
+// only `only_kernel`), with inputs scaled by `scale`
+bool run_kernel_evaluation(const std::string& only_kernel, double scale) {
+    std::cout << "\n============================================================" << std::endl;
+    std::cout << "     ALGORITHM KERNELS (scale " << scale << ")" << std::endl;
+    std::cout << "============================================================" << std::endl;
+    
+    std::ostringstream table;
+    table << std::left << std::setw(16) << "Kernel" << std::setw(10) << "Config" << std::right
+          << std::setw(10) << "Accesses" << std::setw(10) << "L1 Hit" << std::setw(12) << "Victim Hit"
+          << std::setw(10) << "L2 Hit" << std::setw(9) << "AMAT" << std::setw(10) << "MPKI" << "\n";
+    table << std::string(87, '-') << "\n";
+    
+    const std::vector<std::string> configs = {"baseline", "static", "adaptive"};
+    bool ran = false;
+    for (size_t k = 0; k < NUM_KERNELS; k++) {
+        std::string kernel = KERNEL_NAMES[k];
+        if (!only_kernel.empty() && only_kernel != kernel) {
+            continue;
+        }
+        ran = true;
+        
+        for (const std::string& config : configs) {
+            CacheHierarchySimulator sim(config != "baseline", config == "adaptive", sim_config);
+            configure_simulator(sim);
+            std::cout << "\n  Running " << kernel << " (" << config << ")..." << std::endl;
+            SimulatorSink sink(sim);
+            run_kernel(kernel, sink, scale);
+            
+            HierarchyCounters counters = sim.get_counters();
+            uint64_t victim_lookups = counters.l1_accesses - counters.l1_hits;
+            double victim_hit_rate = victim_lookups > 0 ? (double)counters.victim_hits / victim_lookups : 0.0;
+            table << std::left << std::setw(16) << kernel << std::setw(10) << config << std::right
+                  << std::setw(10) << sink.accesses
+                  << std::fixed << std::setprecision(2)
+                  << std::setw(9) << (sim.get_l1_hit_rate() * 100) << "%"
+                  << std::setw(11) << (config == "baseline" ? 0.0 : victim_hit_rate * 100) << "%"
+                  << std::setw(9) << (sim.get_l2_hit_rate() * 100) << "%"
+                  << std::setw(9) << sim.get_amat()
+                  << std::setw(10) << (sim.get_memory_access_rate() * 1000.0) << "\n";
+        }
+        table << "\n";
+    }
+    if (!ran) {
+        std::cerr << "Unknown kernel: " << only_kernel << std::endl;
+        return false;
+    }
+    
+    std::ofstream report("results/KERNEL_REPORT.txt");
+    std::cout << "\n" << table.str();
+    report << table.str();
+    report.close();
+    std::cout << "Kernel report saved to: results/KERNEL_REPORT.txt\n";
+    return true;
+}
+
+// Rates and ratios given on the command line must lie within 0-1
+static bool parse_fraction(const std::string& text, double& value) {
+    double parsed;
+    if (!parse_number(text, parsed) || !(parsed >= 0.0 && parsed <= 1.0)) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    VC_PROFILE_REPORT_AT_EXIT();
+    bool simpoint_mode = false;
+    bool prediction_mode = false;
+    bool comparison_mode = false;
+    bool kernel_mode = false;
+    std::string only_kernel;
+    double kernel_scale = 1.0;
+    uint64_t interval_length = SIMPOINT_INTERVAL_LENGTH;
+    uint32_t max_clusters = SIMPOINT_MAX_CLUSTERS;
+    std::string config_file;
+    std::vector<std::string> config_overrides;
+    bool print_config = false;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--simpoint") {
+            simpoint_mode = true;
+        } else if (arg == "--simpoint-interval" && i + 1 < argc &&
+                   parse_number(argv[i + 1], interval_length) && interval_length > 0) {
+            i++;
+        } else if (arg == "--simpoint-clusters" && i + 1 < argc &&
+                   parse_number(argv[i + 1], max_clusters) && max_clusters > 0) {
+            i++;
+        } else if (arg == "--probe" && i + 1 < argc &&
+                   (std::string(argv[i + 1]) == "serial" || std::string(argv[i + 1]) == "parallel")) {
+            std::string mode = argv[++i];
+            timing_config.probe_mode = (mode == "parallel") ? VICTIM_PROBE_PARALLEL : VICTIM_PROBE_SERIAL;
+        } else if (arg == "--prefetch" && i + 1 < argc &&
+                   Prefetcher::parse_type(argv[i + 1], prefetcher_type)) {
+            i++;
+        } else if (arg == "--prefetch-level" && i + 1 < argc &&
+                   (std::string(argv[i + 1]) == "l1" || std::string(argv[i + 1]) == "l2")) {
+            std::string level = argv[++i];
+            prefetch_level = (level == "l2") ? PREFETCH_AT_L2 : PREFETCH_AT_L1;
+        } else if (arg == "--prefetch-into-victim") {
+            prefetch_into_victim = true;
+        } else if (arg == "--write-ratio" && i + 1 < argc && parse_fraction(argv[i + 1], write_ratio)) {
+            i++;
+        } else if (arg == "--inclusion" && i + 1 < argc &&
+                   CacheHierarchySimulator::parse_inclusion_policy(argv[i + 1], inclusion_policy)) {
+            i++;
+        } else if (arg == "--swap-on-hit") {
+            swap_on_victim_hit = true;
+        } else if (arg == "--predict-phases") {
+            predict_phases = true;
+        } else if (arg == "--phase-prediction") {
+            prediction_mode = true;
+        } else if (arg == "--compare-policies") {
+            comparison_mode = true;
+        } else if (arg == "--kernels") {
+            kernel_mode = true;
+        } else if (arg == "--kernel" && i + 1 < argc) {
+            kernel_mode = true;
+            only_kernel = argv[++i];
+        } else if (arg == "--kernel-scale" && i + 1 < argc &&
+                   parse_number(argv[i + 1], kernel_scale) && kernel_scale > 0.0) {
+            i++;
+        } else if (arg == "--policy" && i + 1 < argc &&
+                   CacheHierarchySimulator::is_adaptation_policy(argv[i + 1])) {
+            adaptation_policy = argv[++i];
+        } else if (arg == "--entry-cost" && i + 1 < argc &&
+                   parse_number(argv[i + 1], entry_cost) && entry_cost >= 0.0) {
+            i++;
+        } else if (arg == "--control" && i + 1 < argc &&
+                   (std::string(argv[i + 1]) == "hit-rate" || std::string(argv[i + 1]) == "occupancy")) {
+            control_metric = argv[++i];
+        } else if (arg == "--setpoint" && i + 1 < argc && parse_fraction(argv[i + 1], control_setpoint)) {
+            i++;
+        } else if (arg == "--objective" && i + 1 < argc &&
+                   (std::string(argv[i + 1]) == "hit-rate" || std::string(argv[i + 1]) == "edp")) {
+            objective = argv[++i];
+        } else if (arg == "--no-power-gating") {
+            power_gating = false;
+        } else if (arg == "--bypass-dueling") {
+            bypass_dueling = true;
+        } else if (arg == "--config" && i + 1 < argc) {
+            config_file = argv[++i];
+        } else if (arg == "--set" && i + 1 < argc) {
+            config_overrides.push_back(argv[++i]);
+        } else if (arg == "--print-config") {
+            print_config = true;
+        } else if (arg == "--host-counters") {
+            host_counters_enabled = true;
+        } else if (arg == "--interval-log" && i + 1 < argc) {
+            interval_log_prefix = argv[++i];
+        } else if (arg == "--interval-format" && i + 1 < argc &&
+                   IntervalMetricsSink::parse_format(argv[i + 1], interval_log_format)) {
+            i++;
+        } else if (arg == "--interval-length" && i + 1 < argc && parse_number(argv[i + 1], interval_log_length)) {
+            i++;
+        } else {
+            std::cerr << "Unknown option or invalid value: " << arg << std::endl;
+            std::cerr << "Usage: " << argv[0] << " [--simpoint] [--simpoint-interval <n>]"
+                      << " [--simpoint-clusters <k>] [--probe serial|parallel]"
+                      << " [--prefetch none|nextline|stride|stream] [--prefetch-level l1|l2]"
+                      << " [--prefetch-into-victim] [--write-ratio <f>]"
+                      << " [--inclusion non-inclusive|inclusive|exclusive] [--swap-on-hit]"
+                      << " [--predict-phases] [--phase-prediction]"
+                      << " [--policy hybrid|mrc|pid|bandit] [--entry-cost <f>]"
+                      << " [--control hit-rate|occupancy] [--setpoint <f>] [--compare-policies]"
+                      << " [--objective hit-rate|edp] [--no-power-gating] [--bypass-dueling]"
+                      << " [--kernels] [--kernel <name>] [--kernel-scale <f>]"
+                      << " [--config <file>] [--set key=value] [--print-config] [--host-counters]"
+                      << " [--interval-log <prefix>] [--interval-format csv|binary] [--interval-length <n>]" << std::endl;
+            return 1;
+        }
+    }
+    
+    // --set wins over the file wherever it appears on the command line
+    if (!config_file.empty() && !sim_config.load_file(config_file)) {
+        return 1;
+    }
+    for (const std::string& assignment : config_overrides) {
+        if (!sim_config.apply_override(assignment)) {
+            return 1;
+        }
+    }
+    if (print_config) {
+        sim_config.write(std::cout);
+        return 0;
+    }
+    
+    if (simpoint_mode) {
+        run_simpoint_evaluation(interval_length, max_clusters);
+        return 0;
+    }
+    
+    if (prediction_mode) {
+        run_phase_prediction_evaluation();
+        return 0;
+    }
+    
+    if (comparison_mode) {
+        run_policy_comparison();
+        return 0;
+    }
+    
+    if (kernel_mode) {
+        return run_kernel_evaluation(only_kernel, kernel_scale) ? 0 : 1;
+    }
+    
+    if (host_counters_enabled && !host_counters.open()) {
+        std::cerr << "[HostCounters] Disabled, " << host_counters.get_error() << std::endl;
+    }
+    
     std::cout << "\n============================================================" << std::endl;
     std::cout << "     CACHE HIERARCHY SIMULATION - REAL PERFORMANCE TEST" << std::endl;
     std::cout << "============================================================" << std::endl;
@@ -182,10 +818,10 @@ int main() {
         std::cout << "\n> Configuration 1: BASELINE (No Victim Cache)";
         results.push_back(simulate_configuration("baseline", workload, "memory_intensive"));
         
-        std::cout << "\n\n> Configuration 2: STATIC Victim Cache (128 entries FIXED)";
+        std::cout << "\n\n> Configuration 2: STATIC Victim Cache (" << static_victim_label() << " FIXED)";
         results.push_back(simulate_configuration("static", workload, "memory_intensive"));
         
-        std::cout << "\n\n> Configuration 3: ADAPTIVE Victim Cache (64-256 entries, starts at 80)";
+        std::cout << "\n\n> Configuration 3: ADAPTIVE Victim Cache (" << adaptive_victim_label() << ")";
         results.push_back(simulate_configuration("adaptive", workload, "memory_intensive"));
         
         compare_results(results, "Memory-Intensive");
@@ -200,10 +836,10 @@ int main() {
         std::cout << "\n> Configuration 1: BASELINE (No Victim Cache)";
         results.push_back(simulate_configuration("baseline", workload, "compute_intensive"));
         
-        std::cout << "\n\n> Configuration 2: STATIC Victim Cache (128 entries FIXED)";
+        std::cout << "\n\n> Configuration 2: STATIC Victim Cache (" << static_victim_label() << " FIXED)";
         results.push_back(simulate_configuration("static", workload, "compute_intensive"));
         
-        std::cout << "\n\n> Configuration 3: ADAPTIVE Victim Cache (64-256 entries, starts at 80)";
+        std::cout << "\n\n> Configuration 3: ADAPTIVE Victim Cache (" << adaptive_victim_label() << ")";
         results.push_back(simulate_configuration("adaptive", workload, "compute_intensive"));
         
         compare_results(results, "Compute-Intensive");
@@ -218,10 +854,10 @@ int main() {
         std::cout << "\n> Configuration 1: BASELINE (No Victim Cache)";
         results.push_back(simulate_configuration("baseline", workload, "mixed"));
         
-        std::cout << "\n\n> Configuration 2: STATIC Victim Cache (128 entries FIXED)";
+        std::cout << "\n\n> Configuration 2: STATIC Victim Cache (" << static_victim_label() << " FIXED)";
         results.push_back(simulate_configuration("static", workload, "mixed"));
         
-        std::cout << "\n\n> Configuration 3: ADAPTIVE Victim Cache (64-256 entries, starts at 80)";
+        std::cout << "\n\n> Configuration 3: ADAPTIVE Victim Cache (" << adaptive_victim_label() << ")";
         results.push_back(simulate_configuration("adaptive", workload, "mixed"));
         
         compare_results(results, "Mixed");
@@ -0,0 +1,247 @@
+#include "cache_simulator.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <map>
+#include <chrono>
+#include <algorithm>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+// Every workload/mode pair runs THROUGHPUT_REPEATS times on the same seeded
+// trace and reports the median rate, so one noisy repeat cannot fail the check
+#define THROUGHPUT_TRACE_LENGTH 500000
+#define THROUGHPUT_SEED 1
+#define THROUGHPUT_REPEATS 3
+#define THROUGHPUT_TOLERANCE_PERCENT 10.0
+
+struct ThroughputResult {
+    std::string workload;
+    std::string mode;
+    double accesses_per_sec;
+    double peak_rss_mb;
+};
+
+// Simulated accesses per second for one fresh hierarchy; trace generation
+// and construction are outside the timed loop
+static double measure(const std::string& mode, const std::vector<uint64_t>& trace) {
+    CacheHierarchySimulator sim(mode != "baseline", mode == "adaptive");
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < trace.size(); i++) {
+        sim.access_memory(trace[i], WorkloadGenerator::access_type(i, DEFAULT_WRITE_RATIO));
+        sim.simulate_instruction();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds > 0.0 ? trace.size() / seconds : 0.0;
+}
+
+// Each pair runs in its own child with stdout silenced, so the peak RSS that
+// wait4() reports belongs to that mode alone. Children run one at a time to
+// keep them from competing for the CPU.
+static bool run_isolated(const std::string& mode, const std::vector<uint64_t>& trace,
+                         uint32_t repeats, ThroughputResult& result) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        std::cerr << "[Throughput] Cannot create pipe" << std::endl;
+        return false;
+    }
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid < 0) {
+        std::cerr << "[Throughput] Cannot fork" << std::endl;
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        int devnull = open("/dev/null", O_WRONLY);
+        if (devnull >= 0) {
+            dup2(devnull, STDOUT_FILENO);
+        }
+        std::vector<double> rates;
+        for (uint32_t r = 0; r < repeats; r++) {
+            rates.push_back(measure(mode, trace));
+        }
+        std::sort(rates.begin(), rates.end());
+        double median = rates[rates.size() / 2];
+        std::cout.flush();
+        _exit(write(fds[1], &median, sizeof(median)) == sizeof(median) ? 0 : 1);
+    }
+    close(fds[1]);
+    
+    double rate = 0.0;
+    bool received = read(fds[0], &rate, sizeof(rate)) == sizeof(rate);
+    close(fds[0]);
+    int status = 0;
+    struct rusage usage;
+    wait4(pid, &status, 0, &usage);
+    if (!received || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        std::cerr << "[Throughput] Run of " << mode << " failed" << std::endl;
+        return false;
+    }
+    
+    result.mode = mode;
+    result.accesses_per_sec = rate;
+    result.peak_rss_mb = usage.ru_maxrss / 1024.0;  // ru_maxrss is in KiB on Linux
+    return true;
+}
+
+static std::string baseline_key(const ThroughputResult& result) {
+    return result.workload + "." + result.mode;
+}
+
+// key=value lines as written by write_baseline(); '#' starts a comment
+static bool load_baseline(const std::string& path, std::map<std::string, double>& values) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line = line.substr(0, comment);
+        }
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) {
+            continue;
+        }
+        std::string key = line.substr(0, eq);
+        key.erase(std::remove(key.begin(), key.end(), ' '), key.end());
+        try {
+            values[key] = std::stod(line.substr(eq + 1));
+        } catch (const std::exception&) {
+            std::cerr << "[Throughput] Bad baseline line: " << line << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+static void write_baseline(const std::string& path, const std::vector<ThroughputResult>& results,
+                           uint64_t length, uint32_t seed) {
+    std::ofstream out(path);
+    out << "# Accesses/sec measured by simulations/throughput; only comparable on the same machine\n";
+    out << "trace.length = " << length << "\n";
+    out << "trace.seed = " << seed << "\n";
+    out << std::fixed << std::setprecision(0);
+    for (const ThroughputResult& r : results) {
+        out << baseline_key(r) << " = " << r.accesses_per_sec << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t trace_length = THROUGHPUT_TRACE_LENGTH;
+    uint32_t seed = THROUGHPUT_SEED;
+    uint32_t repeats = THROUGHPUT_REPEATS;
+    double tolerance = THROUGHPUT_TOLERANCE_PERCENT;
+    std::string baseline_path = "baselines/throughput.txt";
+    bool save_baseline = false;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--length" && i + 1 < argc && parse_number(argv[i + 1], trace_length) && trace_length > 0) {
+            i++;
+        } else if (arg == "--seed" && i + 1 < argc && parse_number(argv[i + 1], seed)) {
+            i++;
+        } else if (arg == "--repeats" && i + 1 < argc && parse_number(argv[i + 1], repeats) && repeats > 0) {
+            i++;
+        } else if (arg == "--tolerance" && i + 1 < argc &&
+                   parse_number(argv[i + 1], tolerance) && tolerance >= 0.0) {
+            i++;
+        } else if (arg == "--baseline" && i + 1 < argc) {
+            baseline_path = argv[++i];
+        } else if (arg == "--save-baseline") {
+            save_baseline = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--length <accesses>] [--seed <n>] [--repeats <n>]"
+                      << " [--tolerance <percent>] [--baseline <file>] [--save-baseline]" << std::endl;
+            return 1;
+        }
+    }
+    if (seed == TRACE_SEED_CLOCK) {
+        std::cerr << "[Throughput] Seed " << TRACE_SEED_CLOCK << " draws a new trace per run; pick another" << std::endl;
+        return 1;
+    }
+    
+    struct Workload {
+        const char* name;
+        std::vector<uint64_t> (*generate)(uint64_t, uint32_t);
+    };
+    const Workload workloads[] = {
+        {"memory_intensive", WorkloadGenerator::generate_memory_intensive},
+        {"compute_intensive", WorkloadGenerator::generate_compute_intensive},
+        {"mixed", WorkloadGenerator::generate_mixed},
+    };
+    const char* modes[] = {"baseline", "static", "adaptive"};
+    
+    std::cout << "============================================================" << std::endl;
+    std::cout << "   Simulator Throughput (" << trace_length << " accesses, seed " << seed
+              << ", median of " << repeats << ")" << std::endl;
+    std::cout << "============================================================" << std::endl;
+    
+    std::vector<ThroughputResult> results;
+    for (const Workload& workload : workloads) {
+        std::vector<uint64_t> trace = workload.generate(trace_length, seed);
+        for (const char* mode : modes) {
+            ThroughputResult result;
+            result.workload = workload.name;
+            if (!run_isolated(mode, trace, repeats, result)) {
+                return 1;
+            }
+            results.push_back(result);
+        }
+    }
+    
+    if (save_baseline) {
+        write_baseline(baseline_path, results, trace_length, seed);
+    }
+    
+    std::map<std::string, double> baseline;
+    bool compare = !save_baseline && load_baseline(baseline_path, baseline);
+    if (compare && (baseline["trace.length"] != trace_length || baseline["trace.seed"] != seed)) {
+        std::cerr << "[Throughput] " << baseline_path << " was recorded with a different trace length or seed" << std::endl;
+        return 1;
+    }
+    
+    std::cout << std::left << std::setw(20) << "Workload" << std::setw(10) << "Mode" << std::right
+              << std::setw(14) << "Accesses/s" << std::setw(12) << "Peak RSS" << std::setw(14) << "Baseline"
+              << std::setw(10) << "Change" << std::endl;
+    std::cout << std::string(80, '-') << std::endl;
+    
+    uint32_t regressions = 0;
+    for (const ThroughputResult& r : results) {
+        std::cout << std::left << std::setw(20) << r.workload << std::setw(10) << r.mode << std::right
+                  << std::fixed << std::setprecision(0) << std::setw(14) << r.accesses_per_sec
+                  << std::setprecision(1) << std::setw(9) << r.peak_rss_mb << " MB";
+        auto it = baseline.find(baseline_key(r));
+        if (compare && it != baseline.end() && it->second > 0.0) {
+            double change = (r.accesses_per_sec - it->second) / it->second * 100.0;
+            bool regressed = change < -tolerance;
+            regressions += regressed;
+            std::cout << std::setprecision(0) << std::setw(14) << it->second
+                      << std::setprecision(1) << std::setw(9) << std::showpos << change << std::noshowpos << "%"
+                      << (regressed ? "  REGRESSION" : "");
+        }
+        std::cout << std::endl;
+    }
+    
+    if (save_baseline) {
+        std::cout << "\nBaseline written to " << baseline_path << std::endl;
+    } else if (!compare) {
+        std::cout << "\nNo baseline at " << baseline_path << "; record one with --save-baseline" << std::endl;
+    } else if (regressions > 0) {
+        std::cout << "\n" << regressions << " configuration(s) slower than the baseline by more than "
+                  << tolerance << "%" << std::endl;
+        return 1;
+    } else {
+        std::cout << "\nAll configurations within " << tolerance << "% of the baseline" << std::endl;
+    }
+    return 0;
+}